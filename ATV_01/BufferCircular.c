@@ -5,72 +5,43 @@ buffer circular.
 2. Implemente o módulo usando TDD.
 ----------------------------------------------------------------------------*/
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "BufferCircular.h"
+#include "broadcast-ring.h"
+#include "delta-ring.h"
+#include "mpmc-queue.h"
+#include "record-ring.h"
+#include "resizable-ring.h"
+#include "ring-static.h"
+#include "spsc-buffer.h"
+#include "window-ring.h"
+#ifdef __linux__
+#include <signal.h>
+#include <sys/resource.h>
+
+#include "blocking-buffer.h"
+#include "mirror-buffer.h"
+#include "persistent-ring.h"
+#include "ring-drain.h"
+#endif
 
 #define ASSERT(mensagem, teste) do { if (!(teste)) return mensagem; } while (0)
 #define RUN_TEST(teste) do { char *mensagem = teste(); total_testes++; \
                              if (mensagem) return mensagem; } while (0)
 
-/* Estrutura que representa um buffer circular */
 typedef struct {
-    int *data;     // Ponteiro para os dados armazenados no buffer
-    int front;     // Índice da posição de inserção no buffer
-    int rear;      // Índice da posição de remoção no buffer
-    int capacity;  // Capacidade total do buffer
-    int size;      // Número atual de elementos no buffer
-} CircularBuffer;
-
-/* Criação de um novo buffer circular */
-CircularBuffer* initializeBuffer(int capacidade) {
-    CircularBuffer *buf = (CircularBuffer *)malloc(sizeof(CircularBuffer));
-    buf->data = (int *)malloc(capacidade * sizeof(int));
-    buf->capacity = capacidade;
-    buf->front = 0;
-    buf->rear = 0;
-    buf->size = 0;
-    return buf;
-}
-
-/* Liberação da memória do buffer */
-void releaseBuffer(CircularBuffer *buf) {
-    free(buf->data);
-    free(buf);
-}
-
-/* Checa se o buffer está cheio */
-int isBufferFull(CircularBuffer *buf) {
-    return buf->size == buf->capacity;
-}
-
-/* Checa se o buffer está vazio */
-int isBufferEmpty(CircularBuffer *buf) {
-    return buf->size == 0;
-}
-
-/* Inserção de um item no buffer */
-void insertItem(CircularBuffer *buf, int item) {
-    if (!isBufferFull(buf)) {
-        buf->data[buf->front] = item;
-        buf->front = (buf->front + 1) % buf->capacity;
-        buf->size++;
-    } else {
-        printf("Buffer está cheio\n");
-    }
-}
+    uint16_t id;
+    int32_t valor;
+} Amostra;
 
-/* Remoção de um item do buffer */
-int removeItem(CircularBuffer *buf) {
-    if (!isBufferEmpty(buf)) {
-        int item = buf->data[buf->rear];
-        buf->rear = (buf->rear + 1) % buf->capacity;
-        buf->size--;
-        return item;
-    } else {
-        printf("Buffer está vazio\n");
-        return -1;
-    }
-}
+RING_DECLARE(ByteRing, uint8_t, 4)
+RING_DECLARE(AmostraRing, Amostra, 2)
+WINDOW_DECLARE(JanelaInt, int, long long, 8)
+WINDOW_DECLARE(JanelaQ8, int16_t, int32_t, 4)
 
 int total_testes = 0;
 
@@ -104,7 +75,8 @@ static char * test_insertItem(void) {
 static char * test_removeItem(void) {
     CircularBuffer *buf = initializeBuffer(3);
     insertItem(buf, 1);
-    int item = removeItem(buf);
+    int item = 0;
+    ASSERT("erro: status de remoção incorreto", removeItem(buf, &item) == BUFFER_OK);
     ASSERT("erro: valor não removido corretamente", item == 1);
     ASSERT("erro: índice de remoção não atualizado", buf->rear == 1);
     ASSERT("erro: tamanho do buffer incorreto após remoção", buf->size == 0);
@@ -132,6 +104,721 @@ static char * test_isBufferEmpty(void) {
     return 0;
 }
 
+/* Teste dos status de retorno: cheio, vazio e o valor -1 armazenável */
+static char * test_bufferStatus(void) {
+    CircularBuffer *buf = initializeBuffer(1);
+    int item = 0;
+    ASSERT("erro: remoção de buffer vazio deveria retornar BUFFER_EMPTY",
+           removeItem(buf, &item) == BUFFER_EMPTY);
+    ASSERT("erro: inserção deveria retornar BUFFER_OK", insertItem(buf, -1) == BUFFER_OK);
+    ASSERT("erro: inserção em buffer cheio deveria retornar BUFFER_FULL",
+           insertItem(buf, 5) == BUFFER_FULL);
+    ASSERT("erro: -1 deveria ser um valor válido",
+           removeItem(buf, &item) == BUFFER_OK && item == -1);
+    BufferStats stats = getBufferStats(buf);
+    ASSERT("erro: contagem de descartes incorreta", stats.drops == 1);
+    ASSERT("erro: nível máximo incorreto", stats.highWater == 1);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste da política de sobrescrita do item mais antigo */
+static char * test_bufferOverwrite(void) {
+    CircularBuffer *buf = initializeBuffer(3);
+    int item = 0;
+    setBufferPolicy(buf, BUFFER_OVERWRITE);
+    for (int i = 1; i <= 3; i++) {
+        insertItem(buf, i);
+    }
+    ASSERT("erro: inserção com sobrescrita deveria retornar BUFFER_OVERWRITTEN",
+           insertItem(buf, 4) == BUFFER_OVERWRITTEN);
+    ASSERT("erro: tamanho deveria continuar na capacidade", buf->size == 3);
+    ASSERT("erro: item mais antigo deveria ter sido descartado",
+           removeItem(buf, &item) == BUFFER_OK && item == 2);
+    int bloco[] = {10, 11, 12, 13, 14};
+    ASSERT("erro: bloco com sobrescrita deveria ser aceito inteiro", insertItems(buf, bloco, 5) == 5);
+    ASSERT("erro: bloco deveria manter os itens mais novos",
+           removeItem(buf, &item) == BUFFER_OK && item == 12);
+    BufferStats stats = getBufferStats(buf);
+    ASSERT("erro: contagem de sobrescritas incorreta", stats.overwrites == 1 + 4);
+    ASSERT("erro: nível máximo incorreto", stats.highWater == 3);
+    ASSERT("erro: não deveria haver descartes", stats.drops == 0);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do modo potência de dois: arredondamento e índices livres */
+static char * test_bufferPow2(void) {
+    CircularBuffer *buf = initializeBufferPow2(5);
+    int item = 0;
+    ASSERT("erro: capacidade não arredondada para potência de dois", buf->capacity == 8);
+    ASSERT("erro: máscara incorreta", buf->mask == 7);
+    for (int i = 0; i < 8; i++) {
+        ASSERT("erro: inserção no modo potência de dois falhou", insertItemPow2(buf, i) == BUFFER_OK);
+    }
+    ASSERT("erro: buffer deveria estar cheio", insertItemPow2(buf, 8) == BUFFER_FULL);
+    ASSERT("erro: contagem incorreta", bufferCountPow2(buf) == 8);
+    ASSERT("erro: remoção falhou", removeItemPow2(buf, &item) == BUFFER_OK && item == 0);
+    ASSERT("erro: inserção após remoção falhou", insertItemPow2(buf, 8) == BUFFER_OK);
+    ASSERT("erro: valor não gravado na posição mascarada", buf->data[0] == 8);
+    setBufferPolicy(buf, BUFFER_OVERWRITE);
+    ASSERT("erro: sobrescrita deveria retornar BUFFER_OVERWRITTEN", insertItemPow2(buf, 9) == BUFFER_OVERWRITTEN);
+    ASSERT("erro: item mais antigo deveria ter sido descartado",
+           removeItemPow2(buf, &item) == BUFFER_OK && item == 2);
+    ASSERT("erro: contagem de sobrescritas incorreta", getBufferStats(buf).overwrites == 1);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do modo potência de dois com índices próximos do overflow */
+static char * test_bufferPow2Overflow(void) {
+    CircularBuffer *buf = initializeBufferPow2(4);
+    int item = 0;
+    buf->front = buf->rear = 0xFFFFFFFEu;
+    for (int i = 0; i < 4; i++) {
+        insertItemPow2(buf, i);
+    }
+    ASSERT("erro: contagem incorreta após overflow do índice", bufferCountPow2(buf) == 4);
+    for (int i = 0; i < 4; i++) {
+        ASSERT("erro: ordem incorreta após overflow do índice",
+               removeItemPow2(buf, &item) == BUFFER_OK && item == i);
+    }
+    ASSERT("erro: buffer deveria estar vazio", removeItemPow2(buf, &item) == BUFFER_EMPTY);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste de inserção/remoção em bloco atravessando o fim do buffer */
+static char * test_insertRemoveItems(void) {
+    CircularBuffer *buf = initializeBuffer(5);
+    int entrada[] = {1, 2, 3, 4, 5, 6};
+    int saida[6] = {0};
+    int descartado;
+    insertItem(buf, 0);
+    insertItem(buf, 0);
+    insertItem(buf, 0);
+    removeItem(buf, &descartado);
+    removeItem(buf, &descartado);
+    removeItem(buf, &descartado);
+    ASSERT("erro: inserção em bloco deveria parar na capacidade",
+           insertItems(buf, entrada, 6) == 5);
+    ASSERT("erro: índice de inserção incorreto após o bloco", buf->front == 3);
+    ASSERT("erro: tamanho incorreto após o bloco", buf->size == 5);
+    ASSERT("erro: segundo segmento não gravado no início", buf->data[0] == 3);
+    ASSERT("erro: remoção em bloco incorreta", removeItems(buf, saida, 6) == 5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT("erro: ordem incorreta na remoção em bloco", saida[i] == entrada[i]);
+    }
+    ASSERT("erro: buffer deveria estar vazio", isBufferEmpty(buf));
+    ASSERT("erro: remoção em bloco de buffer vazio", removeItems(buf, saida, 1) == 0);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste de inserção/remoção em bloco no modo potência de dois */
+static char * test_insertRemoveItemsPow2(void) {
+    CircularBuffer *buf = initializeBufferPow2(4);
+    int entrada[] = {1, 2, 3};
+    int saida[3] = {0};
+    buf->front = buf->rear = 0xFFFFFFFFu;
+    ASSERT("erro: inserção em bloco falhou", insertItems(buf, entrada, 3) == 3);
+    ASSERT("erro: contagem incorreta", bufferCountPow2(buf) == 3);
+    ASSERT("erro: remoção em bloco falhou", removeItems(buf, saida, 3) == 3);
+    ASSERT("erro: ordem incorreta", saida[0] == 1 && saida[1] == 2 && saida[2] == 3);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste de reserva/publicação e leitura/liberação sem cópia */
+static char * test_reserveCommitSpan(void) {
+    CircularBuffer *buf = initializeBuffer(4);
+    int descartado;
+    insertItem(buf, 0);
+    insertItem(buf, 0);
+    insertItem(buf, 0);
+    removeItem(buf, &descartado);
+    removeItem(buf, &descartado);
+    removeItem(buf, &descartado);
+
+    BufferSpan span = reserveSpan(buf, 10);
+    ASSERT("erro: reserva deveria parar no fim de data", span.len == 1);
+    ASSERT("erro: reserva deveria começar em front", span.ptr == &buf->data[3]);
+    span.ptr[0] = 7;
+    ASSERT("erro: item visível antes do commit", isBufferEmpty(buf));
+    commitSpan(buf, 1);
+    ASSERT("erro: índice de inserção incorreto após commit", buf->front == 0);
+
+    span = reserveSpan(buf, 2);
+    ASSERT("erro: segunda reserva deveria começar no início", span.ptr == &buf->data[0]);
+    ASSERT("erro: reserva deveria respeitar n", span.len == 2);
+    span.ptr[0] = 8;
+    span.ptr[1] = 9;
+    commitSpan(buf, 2);
+    ASSERT("erro: tamanho incorreto após commit", buf->size == 3);
+
+    span = peekSpan(buf);
+    ASSERT("erro: leitura deveria parar no fim de data", span.len == 1 && span.ptr[0] == 7);
+    releaseSpan(buf, span.len);
+    span = peekSpan(buf);
+    ASSERT("erro: leitura do segundo trecho incorreta",
+           span.len == 2 && span.ptr[0] == 8 && span.ptr[1] == 9);
+    releaseSpan(buf, 1);
+    int item = 0;
+    ASSERT("erro: liberação parcial incorreta", removeItem(buf, &item) == BUFFER_OK && item == 9);
+    ASSERT("erro: leitura de buffer vazio", peekSpan(buf).len == 0);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do buffer estático de bytes: sem heap, zerado = vazio */
+static char * test_ringStaticBytes(void) {
+    static ByteRing ring;
+    uint8_t item = 0;
+    ASSERT("erro: buffer estático zerado deveria estar vazio", ByteRingIsEmpty(&ring));
+    for (int i = 0; i < 4; i++) {
+        ASSERT("erro: inserção no buffer estático falhou", ByteRingInsert(&ring, (uint8_t)(0xF0 + i)));
+    }
+    ASSERT("erro: buffer estático deveria estar cheio", ByteRingIsFull(&ring));
+    ASSERT("erro: inserção em buffer estático cheio", ByteRingInsert(&ring, 0) == 0);
+    ASSERT("erro: remoção do buffer estático falhou", ByteRingRemove(&ring, &item) && item == 0xF0);
+    ASSERT("erro: contagem do buffer estático incorreta", ByteRingCount(&ring) == 3);
+    ASSERT("erro: elemento de 1 byte esperado", sizeof(ring.data) == 4);
+    return 0;
+}
+
+/* Teste do buffer estático de estruturas na pilha */
+static char * test_ringStaticStruct(void) {
+    AmostraRing ring;
+    Amostra a = {1, -1}, b = {2, 200}, lida;
+    AmostraRingInit(&ring);
+    AmostraRingInsert(&ring, a);
+    AmostraRingInsert(&ring, b);
+    ASSERT("erro: remoção de estrutura falhou", AmostraRingRemove(&ring, &lida));
+    ASSERT("erro: estrutura removida incorreta", lida.id == 1 && lida.valor == -1);
+    ASSERT("erro: remoção de estrutura falhou", AmostraRingRemove(&ring, &lida));
+    ASSERT("erro: estrutura removida incorreta", lida.id == 2 && lida.valor == 200);
+    ASSERT("erro: buffer de estruturas deveria estar vazio", AmostraRingRemove(&ring, &lida) == 0);
+    return 0;
+}
+
+/* Teste do buffer SPSC: ordem FIFO, cheio e vazio */
+static char * test_spscBuffer(void) {
+    SpscBuffer *buf = initializeSpscBuffer(2);
+    int item = 0;
+    ASSERT("erro: buffer SPSC deveria estar vazio", isSpscBufferEmpty(buf));
+    ASSERT("erro: remoção em buffer SPSC vazio", spscRemoveItem(buf, &item) == 0);
+    ASSERT("erro: inserção SPSC falhou", spscInsertItem(buf, 1) == 1);
+    ASSERT("erro: inserção SPSC falhou", spscInsertItem(buf, 2) == 1);
+    ASSERT("erro: buffer SPSC deveria estar cheio", spscInsertItem(buf, 3) == 0);
+    ASSERT("erro: remoção SPSC falhou", spscRemoveItem(buf, &item) == 1 && item == 1);
+    ASSERT("erro: inserção SPSC após remoção falhou", spscInsertItem(buf, 3) == 1);
+    ASSERT("erro: ordem SPSC incorreta", spscRemoveItem(buf, &item) == 1 && item == 2);
+    ASSERT("erro: ordem SPSC incorreta", spscRemoveItem(buf, &item) == 1 && item == 3);
+    ASSERT("erro: buffer SPSC deveria estar vazio", isSpscBufferEmpty(buf));
+    releaseSpscBuffer(buf);
+    return 0;
+}
+
+/* Teste da fila MPMC: ordem FIFO e números de sequência ao dar a volta */
+static char * test_mpmcQueue(void) {
+    MpmcQueue *q = initializeMpmcQueue(3);
+    int item = 0;
+    ASSERT("erro: capacidade MPMC não arredondada", q->capacity == 4);
+    ASSERT("erro: remoção em fila MPMC vazia", mpmcRemoveItem(q, &item) == 0);
+    for (int volta = 0; volta < 3; volta++) {
+        for (int i = 0; i < 4; i++) {
+            ASSERT("erro: inserção MPMC falhou", mpmcInsertItem(q, volta * 10 + i) == 1);
+        }
+        ASSERT("erro: fila MPMC deveria estar cheia", mpmcInsertItem(q, 99) == 0);
+        for (int i = 0; i < 4; i++) {
+            ASSERT("erro: ordem MPMC incorreta",
+                   mpmcRemoveItem(q, &item) == 1 && item == volta * 10 + i);
+        }
+        ASSERT("erro: fila MPMC deveria estar vazia", mpmcRemoveItem(q, &item) == 0);
+    }
+    releaseMpmcQueue(q);
+    return 0;
+}
+
+/* Teste do buffer de difusão: cada leitor recebe todos os itens */
+static char * test_broadcastBlock(void) {
+    BroadcastRing *ring = initializeBroadcastRing(2, BROADCAST_BLOCK);
+    int a = broadcastAddReader(ring);
+    int b = broadcastAddReader(ring);
+    int item = 0;
+    ASSERT("erro: registro de leitor falhou", a >= 0 && b >= 0 && a != b);
+    ASSERT("erro: inserção falhou", broadcastInsertItem(ring, 1));
+    ASSERT("erro: inserção falhou", broadcastInsertItem(ring, 2));
+    ASSERT("erro: escritor deveria esperar o leitor mais lento", broadcastInsertItem(ring, 3) == 0);
+    ASSERT("erro: leitor A não recebeu o item", broadcastRemoveItem(ring, a, &item) && item == 1);
+    ASSERT("erro: escritor deveria esperar o leitor B", broadcastInsertItem(ring, 3) == 0);
+    ASSERT("erro: leitor B não recebeu o item", broadcastRemoveItem(ring, b, &item) && item == 1);
+    ASSERT("erro: inserção após leitores avançarem falhou", broadcastInsertItem(ring, 3));
+    ASSERT("erro: ordem no leitor B incorreta", broadcastRemoveItem(ring, b, &item) && item == 2);
+    ASSERT("erro: ordem no leitor B incorreta", broadcastRemoveItem(ring, b, &item) && item == 3);
+    ASSERT("erro: leitor B não deveria ter itens", broadcastRemoveItem(ring, b, &item) == 0);
+    broadcastRemoveReader(ring, a);
+    ASSERT("erro: leitor removido ainda bloqueia o escritor", broadcastInsertItem(ring, 4));
+    releaseBroadcastRing(ring);
+    return 0;
+}
+
+/* Teste da política de descarte: leitor lento pula e conta o que perdeu */
+static char * test_broadcastDrop(void) {
+    BroadcastRing *ring = initializeBroadcastRing(4, BROADCAST_DROP);
+    int lento = broadcastAddReader(ring);
+    int item = 0;
+    for (int i = 0; i < 10; i++) {
+        ASSERT("erro: escritor não deveria esperar no modo descarte", broadcastInsertItem(ring, i));
+    }
+    ASSERT("erro: leitor lento deveria ler o item mais antigo válido",
+           broadcastRemoveItem(ring, lento, &item) && item == 6);
+    ASSERT("erro: contagem de descartes incorreta", broadcastDropped(ring, lento) == 6);
+    int novo = broadcastAddReader(ring);
+    ASSERT("erro: leitor novo deveria começar vazio", broadcastRemoveItem(ring, novo, &item) == 0);
+    releaseBroadcastRing(ring);
+    return 0;
+}
+
+/* Teste do buffer de registros: tamanhos 0 e 255, volta e reserva parcial */
+static char * test_recordRing(void) {
+    static uint8_t memoria[300];
+    static uint8_t quadro[RECORD_MAX_LEN];
+    RecordRing ring;
+    unsigned tamanho = 0;
+    initializeRecordRing(&ring, memoria, sizeof(memoria));
+
+    ASSERT("erro: buffer de registros deveria estar vazio", recordPeek(&ring, &tamanho) == NULL);
+    memset(quadro, 0xAB, sizeof(quadro));
+    ASSERT("erro: registro de 255 bytes não inserido", recordPush(&ring, quadro, 255));
+    ASSERT("erro: registro vazio não inserido", recordPush(&ring, quadro, 0));
+    ASSERT("erro: registro não deveria caber", recordPush(&ring, quadro, 100) == 0);
+
+    const uint8_t *p = recordPeek(&ring, &tamanho);
+    ASSERT("erro: registro de 255 bytes incorreto", p == &memoria[1] && tamanho == 255 && p[254] == 0xAB);
+    recordPop(&ring);
+    p = recordPeek(&ring, &tamanho);
+    ASSERT("erro: registro vazio incorreto", p != NULL && tamanho == 0);
+    recordPop(&ring);
+
+    /* Não cabe antes do fim: deve recomeçar do início e ser contíguo */
+    uint8_t *w = recordReserve(&ring, 100);
+    ASSERT("erro: reserva deveria recomeçar do início", w == &memoria[1]);
+    w[0] = 'A';
+    w[1] = 'B';
+    recordCommit(&ring, 2);
+    p = recordPeek(&ring, &tamanho);
+    ASSERT("erro: leitor deveria saltar para o início",
+           p == &memoria[1] && tamanho == 2 && p[0] == 'A' && p[1] == 'B');
+    recordPop(&ring);
+    ASSERT("erro: buffer de registros deveria estar vazio", isRecordRingEmpty(&ring));
+    return 0;
+}
+
+/* Teste aleatório do buffer de registros contra uma fila de referência */
+static char * test_recordRingAleatorio(void) {
+    static uint8_t memoria[700];
+    static unsigned tamanhos[4096];
+    RecordRing ring;
+    uint8_t quadro[RECORD_MAX_LEN];
+    unsigned semente = 12345, inseridos = 0, removidos = 0, tamanho;
+    initializeRecordRing(&ring, memoria, sizeof(memoria));
+
+    for (int passo = 0; passo < 200000; passo++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) & 1) {
+            unsigned n = (semente >> 8) % (RECORD_MAX_LEN + 1);
+            memset(quadro, (uint8_t)inseridos, n);
+            if (recordPush(&ring, quadro, n)) {
+                tamanhos[inseridos++ % 4096] = n;
+            }
+        } else {
+            const uint8_t *p = recordPeek(&ring, &tamanho);
+            if (p != NULL) {
+                ASSERT("erro: tamanho de registro incorreto", tamanho == tamanhos[removidos % 4096]);
+                ASSERT("erro: conteúdo de registro incorreto",
+                       tamanho == 0 || (p[0] == (uint8_t)removidos && p[tamanho - 1] == (uint8_t)removidos));
+                ASSERT("erro: registro atravessa o fim da memória", p + tamanho <= memoria + sizeof(memoria));
+                recordPop(&ring);
+                removidos++;
+            } else {
+                ASSERT("erro: buffer vazio com registros pendentes", inseridos == removidos);
+            }
+        }
+    }
+    ASSERT("erro: teste aleatório não exercitou o buffer", removidos > 1000);
+    return 0;
+}
+
+/* Teste do buffer compactado: ida e volta, quadros-chave e ressincronização */
+static char * test_deltaRing(void) {
+    static uint8_t memoria[64];
+    static int32_t referencia[256];
+    DeltaRing ring;
+    int32_t item;
+    unsigned semente = 4242, inseridos = 0, removidos = 0;
+    initializeDeltaRing(&ring, memoria, 100, 8);
+    ASSERT("erro: tamanho deveria ser arredondado para 64", ring.mask == 63);
+
+    int32_t valor = -100000;
+    for (int passo = 0; passo < 50000; passo++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 3 != 0) {
+            int32_t delta = (semente >> 8) % 50 == 0 ? (int32_t)(semente >> 4) : (int32_t)((semente >> 8) % 61) - 30;
+            valor = (int32_t)((uint32_t)valor + (uint32_t)delta);
+            if (deltaInsertItem(&ring, valor) == BUFFER_OK) {
+                referencia[inseridos++ % 256] = valor;
+            }
+        } else if (deltaRemoveItem(&ring, &item)) {
+            ASSERT("erro: amostra decodificada incorreta", item == referencia[removidos++ % 256]);
+        }
+        ASSERT("erro: contagem incorreta", deltaCount(&ring) == inseridos - removidos);
+    }
+    ASSERT("erro: teste aleatório não exercitou o buffer", removidos > 1000 && ring.drops > 0);
+    while (deltaRemoveItem(&ring, &item)) {
+        removidos++;
+    }
+
+    /* Deltas pequenos ocupam 1 byte; quadro-chave a cada 8 amostras */
+    for (int i = 0; i < 16; i++) {
+        deltaInsertItem(&ring, 1000 + i);
+    }
+    ASSERT("erro: 14 deltas de 1 byte + 2 quadros-chave de 2 bytes", deltaBytesUsed(&ring) == 18);
+
+    /* Leitor perde o estado no meio do primeiro quadro-chave e ressincroniza */
+    ring.rear++;
+    ASSERT("erro: deveria descartar os 7 deltas até o quadro-chave",
+           deltaSeekKeyframe(&ring, 1) == 7);
+    ASSERT("erro: contagem após ressincronizar", deltaCount(&ring) == 8);
+    ASSERT("erro: primeira amostra após ressincronizar", deltaRemoveItem(&ring, &item) && item == 1008);
+    ASSERT("erro: delta após ressincronizar", deltaRemoveItem(&ring, &item) && item == 1009);
+
+    /* Sobrescrita: descarta as mais antigas até caber */
+    while (deltaRemoveItem(&ring, &item)) {
+    }
+    ring.policy = BUFFER_OVERWRITE;
+    for (int i = 0; i < 100; i++) {
+        deltaInsertItem(&ring, i * 100);
+    }
+    ASSERT("erro: sobrescrita deveria descartar amostras antigas", ring.overwrites > 0);
+    int32_t ultimo = 0;
+    while (deltaRemoveItem(&ring, &item)) {
+        ultimo = item;
+    }
+    ASSERT("erro: última amostra após sobrescrita", ultimo == 9900);
+    return 0;
+}
+
+/* Teste da janela deslizante contra a varredura completa */
+static char * test_windowAggregates(void) {
+    static JanelaInt janela;
+    int item, referencia[8];
+    unsigned semente = 777, n = 0, inicio = 0;
+    JanelaIntInit(&janela);
+    for (int passo = 0; passo < 20000; passo++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 4 != 0) {
+            int valor = (int)((semente >> 8) % 201) - 100;
+            JanelaIntInsert(&janela, valor);
+            if (n == 8) {
+                inicio++;
+                n--;
+            }
+            referencia[(inicio + n++) % 8] = valor;
+        } else if (JanelaIntRemove(&janela, &item)) {
+            ASSERT("erro: janela removeu a amostra errada", item == referencia[inicio % 8]);
+            inicio++;
+            n--;
+        }
+        ASSERT("erro: quantidade incorreta na janela", JanelaIntCount(&janela) == n);
+        if (n > 0) {
+            int min = referencia[inicio % 8], max = min;
+            long long soma = 0;
+            for (unsigned i = 0; i < n; i++) {
+                int v = referencia[(inicio + i) % 8];
+                min = v < min ? v : min;
+                max = v > max ? v : max;
+                soma += v;
+            }
+            ASSERT("erro: mínimo da janela incorreto", JanelaIntMin(&janela) == min);
+            ASSERT("erro: máximo da janela incorreto", JanelaIntMax(&janela) == max);
+            ASSERT("erro: soma da janela incorreta", JanelaIntSum(&janela) == soma);
+            ASSERT("erro: média da janela incorreta", JanelaIntMean(&janela) == (int)(soma / (long long)n));
+        }
+    }
+
+    /* Ponto fixo Q8.8: 1.5, -2.25, 3.0, 0.75 e depois 4.0 descartando 1.5 */
+    static JanelaQ8 q8;
+    const int16_t amostras[] = {384, -576, 768, 192, 1024};
+    for (int i = 0; i < 4; i++) {
+        ASSERT("erro: janela Q8.8 não deveria descartar", JanelaQ8Insert(&q8, amostras[i]) == 0);
+    }
+    ASSERT("erro: média Q8.8 incorreta", JanelaQ8Mean(&q8) == 192);
+    ASSERT("erro: janela Q8.8 cheia deveria descartar", JanelaQ8Insert(&q8, amostras[4]) == 1);
+    ASSERT("erro: mínimo Q8.8 incorreto", JanelaQ8Min(&q8) == -576);
+    ASSERT("erro: máximo Q8.8 incorreto", JanelaQ8Max(&q8) == 1024);
+    ASSERT("erro: média Q8.8 após descarte incorreta", JanelaQ8Mean(&q8) == 352);
+    return 0;
+}
+
+/* Teste do buffer redimensionável: cresce com itens dando a volta e encolhe */
+static char * test_resizableRing(void) {
+    ResizableRing r;
+    int item = 0;
+    ASSERT("erro: buffer redimensionável não foi criado", initializeResizableRing(&r, 4, 32));
+    /* Desloca os índices para que o conteúdo dê a volta no bloco de 4 */
+    for (int i = 0; i < 3; i++) {
+        resizableInsertItem(&r, 0);
+        resizableRemoveItem(&r, &item);
+    }
+    for (int i = 0; i < 20; i++) {
+        ASSERT("erro: inserção deveria crescer o buffer", resizableInsertItem(&r, i));
+    }
+    ASSERT("erro: capacidade deveria ter crescido para 32", resizableCapacity(&r) == 32);
+    ASSERT("erro: deveria ter crescido três vezes", r.grows == 3);
+    ASSERT("erro: itens deveriam estar lineares no bloco novo", r.producerBlock->data[0] == 0);
+    for (int i = 20; i < 32; i++) {
+        resizableInsertItem(&r, i);
+    }
+    ASSERT("erro: inserção além de maxCapacity deveria falhar", !resizableInsertItem(&r, 99));
+    ASSERT("erro: descarte não contado", r.drops == 1);
+    for (int i = 0; i < 30; i++) {
+        ASSERT("erro: remoção falhou", resizableRemoveItem(&r, &item));
+        ASSERT("erro: ordem incorreta após crescer", item == i);
+    }
+    resizableInsertItem(&r, 32);
+    ASSERT("erro: buffer deveria ter encolhido", resizableCapacity(&r) == 16 && r.shrinks == 1);
+    for (int i = 30; i <= 32; i++) {
+        ASSERT("erro: remoção após encolher falhou", resizableRemoveItem(&r, &item));
+        ASSERT("erro: ordem incorreta após encolher", item == i);
+    }
+    ASSERT("erro: buffer deveria estar vazio", !resizableRemoveItem(&r, &item));
+    releaseResizableRing(&r);
+    ASSERT("erro: memória dos blocos não foi toda liberada", r.bytes == 0);
+    return 0;
+}
+
+#ifdef __linux__
+/* Teste do buffer espelhado: janela contígua atravessando o fim */
+static char * test_bufferMirrored(void) {
+    CircularBuffer *buf = initializeBufferMirrored(10);
+    ASSERT("erro: buffer espelhado não foi criado", buf != NULL);
+    int cap = buf->capacity;
+    ASSERT("erro: capacidade deveria ocupar ao menos uma página", cap * (int)sizeof(int) >= 4096);
+    buf->data[0] = 42;
+    ASSERT("erro: segunda metade não espelha a primeira", buf->data[cap] == 42);
+
+    int item = 0;
+    for (int i = 0; i < cap - 2; i++) {
+        insertItem(buf, 0);
+        removeItem(buf, &item);
+    }
+    for (int i = 0; i < 5; i++) {
+        insertItem(buf, i);
+    }
+    BufferSpan span = peekSpan(buf);
+    ASSERT("erro: janela espelhada deveria ter todos os itens", span.len == 5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT("erro: janela espelhada incorreta", span.ptr[i] == i);
+    }
+    ASSERT("erro: itens após a volta deveriam estar no início", buf->data[0] == 2);
+    releaseSpan(buf, 5);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do buffer persistente: dados pendentes sobrevivem ao fechamento */
+static char * test_persistentRing(void) {
+    char caminho[] = "/tmp/BufferCircularXXXXXX";
+    int fd = mkstemp(caminho);
+    ASSERT("erro: não foi possível criar o arquivo temporário", fd >= 0);
+    close(fd);
+    unlink(caminho);
+
+    PersistentRing ring;
+    int item = 0;
+    ASSERT("erro: arquivo novo deveria ser criado",
+           openPersistentRing(&ring, caminho, 3) == PERSISTENT_CREATED);
+    ASSERT("erro: capacidade persistente não arredondada", ring.capacity == 4);
+    for (int i = 1; i <= 5; i++) {
+        persistentInsertItem(&ring, i);
+    }
+    ASSERT("erro: buffer persistente deveria estar cheio", persistentCount(&ring) == 4);
+    ASSERT("erro: remoção persistente falhou", persistentRemoveItem(&ring, &item) && item == 1);
+    closePersistentRing(&ring);
+
+    ASSERT("erro: reabertura deveria preservar os dados",
+           openPersistentRing(&ring, caminho, 4) == PERSISTENT_OPENED);
+    ASSERT("erro: itens pendentes perdidos", persistentCount(&ring) == 3);
+    ASSERT("erro: ordem após reabertura incorreta", persistentRemoveItem(&ring, &item) && item == 2);
+    /* Simula índices corrompidos */
+    atomic_store(&ring.header->rear, 100);
+    closePersistentRing(&ring);
+
+    ASSERT("erro: cabeçalho inconsistente deveria ser zerado",
+           openPersistentRing(&ring, caminho, 4) == PERSISTENT_RESET);
+    ASSERT("erro: buffer zerado deveria estar vazio", persistentCount(&ring) == 0);
+    closePersistentRing(&ring);
+
+    ASSERT("erro: capacidade diferente deveria falhar",
+           openPersistentRing(&ring, caminho, 64) == PERSISTENT_ERROR);
+    unlink(caminho);
+    ASSERT("erro: capacidade negativa deveria falhar",
+           openPersistentRing(&ring, caminho, -1) == PERSISTENT_ERROR);
+    ASSERT("erro: capacidade zero deveria falhar",
+           openPersistentRing(&ring, caminho, 0) == PERSISTENT_ERROR);
+    ASSERT("erro: capacidade acima de 2^30 deveria falhar",
+           openPersistentRing(&ring, caminho, (1 << 30) + 1) == PERSISTENT_ERROR);
+    return 0;
+}
+
+/* Teste do esvaziamento com writev: dois trechos em uma única chamada */
+static char * test_drainBuffer(void) {
+    CircularBuffer *buf = initializeBuffer(4);
+    BufferDrain d;
+    int fds[2], lidos[4] = {0}, item;
+    ASSERT("erro: pipe", pipe(fds) == 0);
+    initializeDrain(&d, fds[1]);
+    insertItem(buf, 0);
+    insertItem(buf, 0);
+    removeItem(buf, &item);
+    removeItem(buf, &item);
+    for (int i = 1; i <= 4; i++) {
+        insertItem(buf, i);
+    }
+    ASSERT("erro: writev deveria gravar os dois trechos",
+           drainBuffer(&d, buf) == 4 * (ssize_t)sizeof(int));
+    ASSERT("erro: deveria ser uma única syscall", d.syscalls == 1);
+    ASSERT("erro: buffer deveria estar vazio após o esvaziamento", isBufferEmpty(buf));
+    ASSERT("erro: leitura do pipe", read(fds[0], lidos, sizeof(lidos)) == sizeof(lidos));
+    ASSERT("erro: ordem gravada incorreta",
+           lidos[0] == 1 && lidos[1] == 2 && lidos[2] == 3 && lidos[3] == 4);
+    ASSERT("erro: esvaziar buffer vazio deveria retornar 0", drainBuffer(&d, buf) == 0);
+    close(fds[0]);
+    close(fds[1]);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do buffer bloqueante: ordem, prazos e despertar só com espera */
+static char * test_blockingBuffer(void) {
+    BlockingBuffer *b = initializeBlockingBuffer(3, 2);
+    int item = 0;
+    ASSERT("erro: remoção sem espera em buffer vazio deveria falhar",
+           blockingRemoveItem(b, &item, 0) == BUFFER_EMPTY);
+    for (int i = 1; i <= 3; i++) {
+        ASSERT("erro: inserção bloqueante falhou", blockingInsertItem(b, i, -1) == BUFFER_OK);
+    }
+    ASSERT("erro: inserção sem espera em buffer cheio deveria falhar",
+           blockingInsertItem(b, 4, 0) == BUFFER_FULL);
+
+    struct timespec t0, t1;
+    atomic_store(&b->freed, 1);  // Sobra de uma espera anterior
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ASSERT("erro: inserção com prazo em buffer cheio deveria expirar",
+           blockingInsertItem(b, 4, 20) == BUFFER_FULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    long ms = (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000;
+    ASSERT("erro: prazo da inserção não foi respeitado", ms >= 19);
+    ASSERT("erro: produtor que desiste deveria zerar o lote", atomic_load(&b->freed) == 0);
+    ASSERT("erro: a espera deveria usar o futex", b->waitCalls > 0);
+
+    for (int i = 1; i <= 3; i++) {
+        ASSERT("erro: remoção bloqueante falhou", blockingRemoveItem(b, &item, -1) == BUFFER_OK);
+        ASSERT("erro: ordem incorreta no buffer bloqueante", item == i);
+    }
+    ASSERT("erro: remoção com prazo em buffer vazio deveria expirar",
+           blockingRemoveItem(b, &item, 10) == BUFFER_EMPTY);
+    ASSERT("erro: sem ninguém dormindo não deveria haver FUTEX_WAKE", b->wakeCalls == 0);
+    releaseBlockingBuffer(b);
+    return 0;
+}
+
+#ifdef URING_DRAIN_DEPTH
+/* Teste do esvaziamento com io_uring: 'rear' só avança na conclusão */
+static char * test_uringDrain(void) {
+    char caminho[] = "/tmp/BufferCircularXXXXXX";
+    int fd = mkstemp(caminho);
+    ASSERT("erro: não foi possível criar o arquivo temporário", fd >= 0);
+    unlink(caminho);
+
+    CircularBuffer *buf = initializeBufferPow2(4);
+    UringDrain u;
+    int lidos[6] = {0};
+    if (uringDrainInit(&u, fd, 0) != 0) {
+        /* Kernel sem io_uring: o caminho com writev continua disponível */
+        close(fd);
+        releaseBuffer(buf);
+        return 0;
+    }
+    for (int i = 1; i <= 3; i++) insertItemPow2(buf, i);
+    ASSERT("erro: submissão io_uring falhou", uringDrainSubmit(&u, buf) == 3);
+    ASSERT("erro: rear avançou antes da conclusão", bufferCountPow2(buf) == 3);
+    for (int i = 4; i <= 6; i++) insertItemPow2(buf, i);
+    ASSERT("erro: produtor não deveria sobrescrever dados em voo", bufferCountPow2(buf) == 4);
+    ASSERT("erro: segunda submissão deveria pegar só o item novo", uringDrainSubmit(&u, buf) == 1);
+    ASSERT("erro: espera io_uring falhou", uringDrainWait(&u, buf, 2) == 0);
+    ASSERT("erro: rear deveria avançar após a conclusão", bufferCountPow2(buf) == 0);
+    ASSERT("erro: leitura do arquivo", pread(fd, lidos, sizeof(lidos), 0) == 4 * sizeof(int));
+    ASSERT("erro: conteúdo gravado pelo io_uring incorreto",
+           lidos[0] == 1 && lidos[1] == 2 && lidos[2] == 3 && lidos[3] == 4);
+    uringDrainRelease(&u);
+    close(fd);
+    releaseBuffer(buf);
+    return 0;
+}
+
+/* Teste do io_uring com gravação curta: só o gravado sai do buffer */
+static char * test_uringDrainErro(void) {
+    char caminho[] = "/tmp/BufferCircularXXXXXX";
+    int fd = mkstemp(caminho);
+    ASSERT("erro: não foi possível criar o arquivo temporário", fd >= 0);
+    unlink(caminho);
+
+    CircularBuffer *buf = initializeBufferPow2(4096);
+    UringDrain u;
+    if (uringDrainInit(&u, fd, 0) != 0) {
+        close(fd);
+        releaseBuffer(buf);
+        return 0;
+    }
+    for (int i = 0; i < 3000; i++) insertItemPow2(buf, i);
+
+    /* Limite de 4098 bytes: a gravação para no meio do item 1024 */
+    struct rlimit antes, limite;
+    getrlimit(RLIMIT_FSIZE, &antes);
+    limite = antes;
+    limite.rlim_cur = 4098;
+    void (*sinal)(int) = signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limite);
+    ASSERT("erro: submissão io_uring falhou", uringDrainSubmit(&u, buf) == 3000);
+    int espera = uringDrainWait(&u, buf, 1);
+    setrlimit(RLIMIT_FSIZE, &antes);
+    signal(SIGXFSZ, sinal);
+    ASSERT("erro: gravação curta deveria ser reportada", espera == -1 && u.error == EIO);
+    ASSERT("erro: só os itens gravados deveriam sair do buffer", bufferCountPow2(buf) == 3000 - 1024);
+    ASSERT("erro: bytes do item cortado não registrados", u.partial == 2);
+    ASSERT("erro: submissão com erro pendente deveria ser recusada", uringDrainSubmit(&u, buf) == 0);
+
+    ASSERT("erro: nova tentativa deveria ser aceita", uringDrainRetry(&u) == 0);
+    ASSERT("erro: nova submissão deveria pegar os itens restantes", uringDrainSubmit(&u, buf) == 3000 - 1024);
+    ASSERT("erro: espera io_uring falhou", uringDrainWait(&u, buf, 1) == 0);
+    ASSERT("erro: buffer deveria estar vazio", bufferCountPow2(buf) == 0);
+
+    static int lidos[3001];
+    ASSERT("erro: arquivo deveria ter todos os itens",
+           pread(fd, lidos, sizeof(lidos), 0) == 3000 * sizeof(int));
+    for (int i = 0; i < 3000; i++) {
+        ASSERT("erro: conteúdo após nova tentativa incorreto", lidos[i] == i);
+    }
+    uringDrainRelease(&u);
+    close(fd);
+    releaseBuffer(buf);
+    return 0;
+}
+#endif
+#endif
+
 /* Função que executa todos os testes */
 static char * run_tests(void) {
     RUN_TEST(test_initializeBuffer);
@@ -139,6 +826,34 @@ static char * run_tests(void) {
     RUN_TEST(test_removeItem);
     RUN_TEST(test_isBufferFull);
     RUN_TEST(test_isBufferEmpty);
+    RUN_TEST(test_bufferStatus);
+    RUN_TEST(test_bufferOverwrite);
+    RUN_TEST(test_bufferPow2);
+    RUN_TEST(test_bufferPow2Overflow);
+    RUN_TEST(test_insertRemoveItems);
+    RUN_TEST(test_insertRemoveItemsPow2);
+    RUN_TEST(test_reserveCommitSpan);
+    RUN_TEST(test_ringStaticBytes);
+    RUN_TEST(test_ringStaticStruct);
+    RUN_TEST(test_spscBuffer);
+    RUN_TEST(test_mpmcQueue);
+    RUN_TEST(test_broadcastBlock);
+    RUN_TEST(test_broadcastDrop);
+    RUN_TEST(test_recordRing);
+    RUN_TEST(test_recordRingAleatorio);
+    RUN_TEST(test_resizableRing);
+    RUN_TEST(test_windowAggregates);
+    RUN_TEST(test_deltaRing);
+#ifdef __linux__
+    RUN_TEST(test_bufferMirrored);
+    RUN_TEST(test_persistentRing);
+    RUN_TEST(test_drainBuffer);
+    RUN_TEST(test_blockingBuffer);
+#ifdef URING_DRAIN_DEPTH
+    RUN_TEST(test_uringDrain);
+    RUN_TEST(test_uringDrainErro);
+#endif
+#endif
     return 0;
 }
 
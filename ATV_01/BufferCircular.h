@@ -0,0 +1,393 @@
+/*--------------------------------------------------------------------------
+Módulo de buffer circular.
+
+Implementado somente em cabeçalho (como pt.h/lc.h na ATV_04) para que os
+programas de teste e de benchmark continuem sendo compilados com um único
+arquivo:  gcc -g BufferCircular.c -o BufferCircular
+----------------------------------------------------------------------------*/
+
+#ifndef BUFFER_CIRCULAR_H
+#define BUFFER_CIRCULAR_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Resultado das operações de inserção/remoção */
+typedef enum {
+    BUFFER_OK = 0,       // Operação realizada
+    BUFFER_OVERWRITTEN,  // Item inserido descartando o mais antigo (BUFFER_OVERWRITE)
+    BUFFER_FULL,         // Item descartado: buffer cheio (BUFFER_REJECT)
+    BUFFER_EMPTY         // Nenhum item para remover
+} BufferStatus;
+
+/* Comportamento da inserção com o buffer cheio */
+typedef enum {
+    BUFFER_REJECT = 0,   // Descarta o item novo (padrão)
+    BUFFER_OVERWRITE     // Descarta o item mais antigo (telemetria com perdas)
+} BufferPolicy;
+
+/*
+ * Contadores do buffer. São atualizados apenas pelo lado que insere,
+ * com loads/stores atômicos relaxed (sem read-modify-write), então outra
+ * thread ou uma tarefa de monitoramento pode lê-los sem trava.
+ */
+typedef struct {
+    unsigned drops;      // Itens rejeitados com o buffer cheio
+    unsigned overwrites; // Itens antigos sobrescritos
+    unsigned highWater;  // Maior ocupação já observada
+} BufferStats;
+
+/* Estrutura que representa um buffer circular */
+typedef struct CircularBuffer CircularBuffer;
+struct CircularBuffer {
+    int *data;             // Ponteiro para os dados armazenados no buffer
+    unsigned front;        // Índice da posição de inserção no buffer
+    unsigned rear;         // Índice da posição de remoção no buffer
+    int capacity;          // Capacidade total do buffer
+    int size;              // Número atual de elementos no buffer (modo módulo)
+    unsigned mask;         // capacity - 1 no modo potência de dois, 0 no modo módulo
+    BufferPolicy policy;   // Comportamento com o buffer cheio
+    atomic_uint drops;     // Ver BufferStats
+    atomic_uint overwrites;
+    atomic_uint highWater;
+    int mirrored;          // 1 se data[capacity..2*capacity) espelha data[0..capacity)
+    void (*releaseData)(CircularBuffer *buf); // Liberação de 'data' (NULL = free)
+};
+
+/* Criação de um novo buffer circular */
+static inline CircularBuffer* initializeBuffer(int capacidade) {
+    CircularBuffer *buf = (CircularBuffer *)malloc(sizeof(CircularBuffer));
+    buf->data = (int *)malloc(capacidade * sizeof(int));
+    buf->capacity = capacidade;
+    buf->front = 0;
+    buf->rear = 0;
+    buf->size = 0;
+    buf->mask = 0;
+    buf->policy = BUFFER_REJECT;
+    atomic_init(&buf->drops, 0);
+    atomic_init(&buf->overwrites, 0);
+    atomic_init(&buf->highWater, 0);
+    buf->mirrored = 0;
+    buf->releaseData = NULL;
+    return buf;
+}
+
+/*
+ * Criação de um buffer no modo potência de dois.
+ *
+ * A capacidade é arredondada para a próxima potência de dois (mínimo 2).
+ * Os índices 'front' e 'rear' correm livres (unsigned, com overflow bem
+ * definido) e são mascarados somente no acesso a 'data'; o número de
+ * elementos é front - rear, então 'size' não é usado. Isso elimina a
+ * divisão de '%' em cada operação, que no Cortex-M0+ (sem instrução de
+ * divisão) é uma chamada a __aeabi_uidivmod.
+ *
+ * Neste modo use insertItemPow2/removeItemPow2/bufferCountPow2.
+ */
+static inline CircularBuffer* initializeBufferPow2(int capacidade) {
+    unsigned cap = 2;
+    while (cap < (unsigned)capacidade) {
+        cap <<= 1;
+    }
+    CircularBuffer *buf = initializeBuffer((int)cap);
+    buf->mask = cap - 1;
+    return buf;
+}
+
+/* Liberação da memória do buffer */
+static inline void releaseBuffer(CircularBuffer *buf) {
+    if (buf->releaseData) {
+        buf->releaseData(buf);
+    } else {
+        free(buf->data);
+    }
+    free(buf);
+}
+
+/* Escolha do comportamento com o buffer cheio */
+static inline void setBufferPolicy(CircularBuffer *buf, BufferPolicy politica) {
+    buf->policy = politica;
+}
+
+/* Incremento de contador com um único escritor (sem read-modify-write atômico) */
+static inline void bufferCounterAdd(atomic_uint *contador, unsigned n) {
+    atomic_store_explicit(contador,
+                          atomic_load_explicit(contador, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+/* Atualização da maior ocupação observada */
+static inline void bufferUpdateHighWater(CircularBuffer *buf, unsigned ocupacao) {
+    if (ocupacao > atomic_load_explicit(&buf->highWater, memory_order_relaxed)) {
+        atomic_store_explicit(&buf->highWater, ocupacao, memory_order_relaxed);
+    }
+}
+
+/* Leitura dos contadores (pode ser feita de outra thread sem trava) */
+static inline BufferStats getBufferStats(CircularBuffer *buf) {
+    BufferStats stats;
+    stats.drops = atomic_load_explicit(&buf->drops, memory_order_relaxed);
+    stats.overwrites = atomic_load_explicit(&buf->overwrites, memory_order_relaxed);
+    stats.highWater = atomic_load_explicit(&buf->highWater, memory_order_relaxed);
+    return stats;
+}
+
+/* Checa se o buffer está cheio */
+static inline int isBufferFull(CircularBuffer *buf) {
+    return buf->size == buf->capacity;
+}
+
+/* Checa se o buffer está vazio */
+static inline int isBufferEmpty(CircularBuffer *buf) {
+    return buf->size == 0;
+}
+
+/*
+ * Inserção de um item no buffer.
+ *
+ * Com o buffer cheio retorna BUFFER_FULL (política BUFFER_REJECT) ou
+ * descarta o item mais antigo e retorna BUFFER_OVERWRITTEN (política
+ * BUFFER_OVERWRITE). Nunca bloqueia nem escreve no console.
+ */
+static inline BufferStatus insertItem(CircularBuffer *buf, int item) {
+    BufferStatus status = BUFFER_OK;
+    if (isBufferFull(buf)) {
+        if (buf->policy == BUFFER_REJECT) {
+            bufferCounterAdd(&buf->drops, 1);
+            return BUFFER_FULL;
+        }
+        buf->rear = (buf->rear + 1) % buf->capacity;
+        buf->size--;
+        bufferCounterAdd(&buf->overwrites, 1);
+        status = BUFFER_OVERWRITTEN;
+    }
+    buf->data[buf->front] = item;
+    buf->front = (buf->front + 1) % buf->capacity;
+    buf->size++;
+    bufferUpdateHighWater(buf, (unsigned)buf->size);
+    return status;
+}
+
+/* Remoção de um item do buffer. Retorna BUFFER_EMPTY se não houver itens. */
+static inline BufferStatus removeItem(CircularBuffer *buf, int *item) {
+    if (isBufferEmpty(buf)) {
+        return BUFFER_EMPTY;
+    }
+    *item = buf->data[buf->rear];
+    buf->rear = (buf->rear + 1) % buf->capacity;
+    buf->size--;
+    return BUFFER_OK;
+}
+
+/* Número de elementos no buffer (modo potência de dois) */
+static inline unsigned bufferCountPow2(CircularBuffer *buf) {
+    return buf->front - buf->rear;
+}
+
+/*
+ * Inserção de um item no buffer (modo potência de dois). Retorna o mesmo
+ * que insertItem: BUFFER_OK, BUFFER_OVERWRITTEN ou BUFFER_FULL.
+ */
+static inline BufferStatus insertItemPow2(CircularBuffer *buf, int item) {
+    BufferStatus status = BUFFER_OK;
+    if (buf->front - buf->rear == (unsigned)buf->capacity) {
+        if (buf->policy == BUFFER_REJECT) {
+            bufferCounterAdd(&buf->drops, 1);
+            return BUFFER_FULL;
+        }
+        buf->rear++;
+        bufferCounterAdd(&buf->overwrites, 1);
+        status = BUFFER_OVERWRITTEN;
+    }
+    buf->data[buf->front & buf->mask] = item;
+    buf->front++;
+    bufferUpdateHighWater(buf, buf->front - buf->rear);
+    return status;
+}
+
+/* Remoção de um item do buffer (modo potência de dois). Retorna BUFFER_EMPTY se vazio. */
+static inline BufferStatus removeItemPow2(CircularBuffer *buf, int *item) {
+    if (buf->front == buf->rear) {
+        return BUFFER_EMPTY;
+    }
+    *item = buf->data[buf->rear & buf->mask];
+    buf->rear++;
+    return BUFFER_OK;
+}
+
+/* Número de elementos no buffer (qualquer modo) */
+static inline int bufferCount(CircularBuffer *buf) {
+    return buf->mask ? (int)(buf->front - buf->rear) : buf->size;
+}
+
+/* Posição física em 'data' de um índice (qualquer modo) */
+static inline int bufferSlot(CircularBuffer *buf, unsigned indice) {
+    return buf->mask ? (int)(indice & buf->mask) : (int)indice;
+}
+
+/* Avança 'front' em n posições já gravadas (qualquer modo) */
+static inline void advanceFront(CircularBuffer *buf, int n) {
+    if (buf->mask) {
+        buf->front += n;
+    } else {
+        buf->front += n;
+        if (buf->front >= (unsigned)buf->capacity) {
+            buf->front -= buf->capacity;
+        }
+        buf->size += n;
+    }
+}
+
+/* Avança 'rear' em n posições já lidas (qualquer modo) */
+static inline void advanceRear(CircularBuffer *buf, int n) {
+    if (buf->mask) {
+        buf->rear += n;
+    } else {
+        buf->rear += n;
+        if (buf->rear >= (unsigned)buf->capacity) {
+            buf->rear -= buf->capacity;
+        }
+        buf->size -= n;
+    }
+}
+
+/*
+ * Inserção de um bloco de até n itens.
+ *
+ * Copia no máximo dois segmentos contíguos (até o fim de 'data' e depois
+ * a partir do início) com memcpy. Retorna quantos itens foram aceitos:
+ * na política BUFFER_REJECT é menor que n se não houver espaço para
+ * todos; na BUFFER_OVERWRITE é sempre n, e os itens mais antigos (do
+ * buffer e, se n > capacity, do próprio bloco) contam como sobrescritos.
+ */
+static inline int insertItems(CircularBuffer *buf, const int *src, int n) {
+    int livre = buf->capacity - bufferCount(buf);
+    int aceitos = n;
+    if (n > livre) {
+        if (buf->policy == BUFFER_REJECT) {
+            bufferCounterAdd(&buf->drops, (unsigned)(n - livre));
+            n = aceitos = livre;
+        } else {
+            if (n > buf->capacity) {
+                src += n - buf->capacity;
+                n = buf->capacity;
+            }
+            if (n > livre) {
+                advanceRear(buf, n - livre);
+            }
+            bufferCounterAdd(&buf->overwrites, (unsigned)(aceitos - livre));
+        }
+    }
+    if (n <= 0) {
+        return 0;
+    }
+    int pos = bufferSlot(buf, buf->front);
+    int primeiro = buf->mirrored ? n : buf->capacity - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    memcpy(&buf->data[pos], src, primeiro * sizeof(int));
+    memcpy(&buf->data[0], src + primeiro, (n - primeiro) * sizeof(int));
+    advanceFront(buf, n);
+    bufferUpdateHighWater(buf, (unsigned)bufferCount(buf));
+    return aceitos;
+}
+
+/*
+ * Remoção de um bloco de até n itens para 'dst'.
+ *
+ * Retorna quantos itens foram removidos (0 se o buffer estiver vazio).
+ */
+static inline int removeItems(CircularBuffer *buf, int *dst, int n) {
+    int ocupado = bufferCount(buf);
+    if (n > ocupado) {
+        n = ocupado;
+    }
+    if (n <= 0) {
+        return 0;
+    }
+    int pos = bufferSlot(buf, buf->rear);
+    int primeiro = buf->mirrored ? n : buf->capacity - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    memcpy(dst, &buf->data[pos], primeiro * sizeof(int));
+    memcpy(dst + primeiro, &buf->data[0], (n - primeiro) * sizeof(int));
+    advanceRear(buf, n);
+    return n;
+}
+
+/* Trecho contíguo de 'data' entregue sem cópia ao produtor ou ao consumidor */
+typedef struct {
+    int *ptr;  // Início do trecho dentro de 'data'
+    int len;   // Número de itens disponíveis a partir de 'ptr'
+} BufferSpan;
+
+/*
+ * Reserva de espaço para escrita direta em 'data' (produtor).
+ *
+ * Retorna o maior trecho contíguo livre a partir de 'front', limitado a
+ * n itens; perto do fim de 'data' o trecho pode ser menor que o espaço
+ * livre total, e uma segunda reserva devolve o restante a partir do
+ * início (em um buffer espelhado o trecho é sempre todo o espaço livre).
+ * Nada é publicado até commitSpan.
+ */
+static inline BufferSpan reserveSpan(CircularBuffer *buf, int n) {
+    BufferSpan span;
+    int livre = buf->capacity - bufferCount(buf);
+    int pos = bufferSlot(buf, buf->front);
+    span.len = buf->mirrored ? livre : buf->capacity - pos;
+    if (span.len > livre) {
+        span.len = livre;
+    }
+    if (span.len > n) {
+        span.len = n;
+    }
+    span.ptr = &buf->data[pos];
+    return span;
+}
+
+/* Publica n itens escritos no trecho devolvido por reserveSpan */
+static inline void commitSpan(CircularBuffer *buf, int n) {
+    int livre = buf->capacity - bufferCount(buf);
+    if (n > livre) {
+        n = livre;
+    }
+    if (n > 0) {
+        advanceFront(buf, n);
+        bufferUpdateHighWater(buf, (unsigned)bufferCount(buf));
+    }
+}
+
+/*
+ * Acesso de leitura direto a 'data' (consumidor).
+ *
+ * Retorna o trecho contíguo ocupado a partir de 'rear' (len == 0 se o
+ * buffer estiver vazio); em um buffer espelhado são todos os itens.
+ * Os itens continuam no buffer até releaseSpan.
+ */
+static inline BufferSpan peekSpan(CircularBuffer *buf) {
+    BufferSpan span;
+    int ocupado = bufferCount(buf);
+    int pos = bufferSlot(buf, buf->rear);
+    span.len = buf->mirrored ? ocupado : buf->capacity - pos;
+    if (span.len > ocupado) {
+        span.len = ocupado;
+    }
+    span.ptr = &buf->data[pos];
+    return span;
+}
+
+/* Libera n itens já consumidos do trecho devolvido por peekSpan */
+static inline void releaseSpan(CircularBuffer *buf, int n) {
+    int ocupado = bufferCount(buf);
+    if (n > ocupado) {
+        n = ocupado;
+    }
+    if (n > 0) {
+        advanceRear(buf, n);
+    }
+}
+
+#endif /* BUFFER_CIRCULAR_H */
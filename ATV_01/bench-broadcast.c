@@ -0,0 +1,113 @@
+/*--------------------------------------------------------------------------
+Benchmark do buffer de difusão (broadcast-ring.h) com 1 a 8 leitores.
+
+Um escritor insere N itens (0..N-1) e cada leitor lê até ver o último.
+Mostra a vazão do escritor, o total de itens entregues a todos os
+leitores e, na política BROADCAST_DROP, quantos itens foram perdidos.
+Na política BROADCAST_BLOCK a soma de cada leitor é conferida.
+
+Compilação:  gcc -O2 -pthread bench-broadcast.c -o bench-broadcast
+Uso:         ./bench-broadcast [itens] [capacidade]
+
+Com o buffer cheio/vazio as threads cedem o processador (sched_yield).
+----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "broadcast-ring.h"
+
+static long total_itens = 5000000;
+static int capacidade = 4096;
+static BroadcastRing *ring;
+
+typedef struct {
+    pthread_t thread;
+    int leitor;
+    long lidos;
+    long long soma;
+} Leitor;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *escritor(void *arg) {
+    (void)arg;
+    for (long i = 0; i < total_itens; i++) {
+        while (!broadcastInsertItem(ring, (int)i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *leitor(void *arg) {
+    Leitor *l = (Leitor *)arg;
+    int item = -1;
+    while (item != total_itens - 1) {
+        if (broadcastRemoveItem(ring, l->leitor, &item)) {
+            l->lidos++;
+            l->soma += item;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void executar(BroadcastPolicy politica, int nLeitores) {
+    Leitor leitores[BROADCAST_MAX_READERS] = {0};
+    pthread_t te;
+
+    ring = initializeBroadcastRing(capacidade, politica);
+    for (int i = 0; i < nLeitores; i++) {
+        leitores[i].leitor = broadcastAddReader(ring);
+    }
+
+    double inicio = agora();
+    for (int i = 0; i < nLeitores; i++) {
+        pthread_create(&leitores[i].thread, NULL, leitor, &leitores[i]);
+    }
+    pthread_create(&te, NULL, escritor, NULL);
+    pthread_join(te, NULL);
+    for (int i = 0; i < nLeitores; i++) {
+        pthread_join(leitores[i].thread, NULL);
+    }
+    double tempo = agora() - inicio;
+
+    long entregues = 0;
+    unsigned long perdidos = 0;
+    int ok = 1;
+    long long esperado = (long long)total_itens * (total_itens - 1) / 2;
+    for (int i = 0; i < nLeitores; i++) {
+        entregues += leitores[i].lidos;
+        perdidos += broadcastDropped(ring, leitores[i].leitor);
+        if (leitores[i].lidos + (long)broadcastDropped(ring, leitores[i].leitor) != total_itens) ok = 0;
+        if (politica == BROADCAST_BLOCK && leitores[i].soma != esperado) ok = 0;
+    }
+
+    printf("%-6s %2d leitores  %8.2f Mitens/s escritos  %9.2f Mitens/s entregues  %10lu perdidos  %s\n",
+           politica == BROADCAST_BLOCK ? "block" : "drop", nLeitores, total_itens / tempo / 1e6,
+           entregues / tempo / 1e6, perdidos, ok ? "ok" : "CONTAGEM INCORRETA");
+    releaseBroadcastRing(ring);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_itens = atol(argv[1]);
+    if (argc > 2) capacidade = atoi(argv[2]);
+
+    printf("itens=%ld capacidade=%d\n", total_itens, capacidade);
+    for (int n = 1; n <= BROADCAST_MAX_READERS; n *= 2) {
+        executar(BROADCAST_BLOCK, n);
+    }
+    for (int n = 1; n <= BROADCAST_MAX_READERS; n *= 2) {
+        executar(BROADCAST_DROP, n);
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------------
+Benchmark: inserção/remoção em bloco (insertItems/removeItems, dois
+memcpy no máximo) contra um laço de insertItem/removeItem por elemento.
+
+Para cada tamanho de bloco de 16 a 4096 itens o produtor insere um bloco
+e o consumidor o remove, até transferir o mesmo total de itens. A
+capacidade (10007) não divide os blocos, então as cópias atravessam o
+fim do buffer com frequência.
+
+Compilação:  gcc -O2 bench-bulk.c -o bench-bulk
+Uso:         ./bench-bulk [itens por medição]
+----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+
+#define CAPACIDADE 10007
+#define MAX_BLOCO  4096
+
+static long total_itens = 50000000;
+static int origem[MAX_BLOCO];
+static int destino[MAX_BLOCO];
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double medirLaco(CircularBuffer *buf, int bloco, long long *soma) {
+    long rodadas = total_itens / bloco;
+    double inicio = agora();
+    for (long r = 0; r < rodadas; r++) {
+        for (int i = 0; i < bloco; i++) {
+            insertItem(buf, origem[i]);
+        }
+        for (int i = 0; i < bloco; i++) {
+            removeItem(buf, &destino[i]);
+        }
+        *soma += destino[bloco - 1];
+    }
+    return agora() - inicio;
+}
+
+static double medirBloco(CircularBuffer *buf, int bloco, long long *soma) {
+    long rodadas = total_itens / bloco;
+    double inicio = agora();
+    for (long r = 0; r < rodadas; r++) {
+        insertItems(buf, origem, bloco);
+        removeItems(buf, destino, bloco);
+        *soma += destino[bloco - 1];
+    }
+    return agora() - inicio;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_itens = atol(argv[1]);
+
+    for (int i = 0; i < MAX_BLOCO; i++) {
+        origem[i] = i;
+    }
+
+    printf("itens por medição=%ld capacidade=%d\n", total_itens, CAPACIDADE);
+    printf("%6s %14s %14s %8s\n", "bloco", "laço (Mit/s)", "bloco (Mit/s)", "ganho");
+
+    CircularBuffer *buf = initializeBuffer(CAPACIDADE);
+    for (int bloco = 16; bloco <= MAX_BLOCO; bloco *= 4) {
+        long long somaLaco = 0, somaBloco = 0;
+        double tLaco = medirLaco(buf, bloco, &somaLaco);
+        double tBloco = medirBloco(buf, bloco, &somaBloco);
+        long itens = total_itens / bloco * bloco;
+        printf("%6d %14.1f %14.1f %7.2fx%s\n", bloco, itens / tLaco / 1e6,
+               itens / tBloco / 1e6, tLaco / tBloco,
+               somaLaco == somaBloco ? "" : "  SOMA INCORRETA");
+    }
+    releaseBuffer(buf);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*--------------------------------------------------------------------------
+Benchmark: buffer compactado (delta-ring.h) contra 4 bytes por amostra.
+
+Para três sinais típicos mede a razão de compressão (4 bytes / bytes por
+amostra, incluindo os quadros-chave) e a vazão de codificação
+(deltaInsertItem) e decodificação (deltaRemoveItem), comparando com
+insertItemPow2/removeItemPow2 de um CircularBuffer comum.
+
+  adc      passeio aleatório de +-4 contagens (ADC de 12 bits);
+  senoide  senoide lenta com ruído de +-2;
+  degraus  valor quase constante com saltos grandes a cada 500 amostras.
+
+Compilação:  gcc -O2 bench-delta.c -lm -o bench-delta
+Uso:         ./bench-delta [amostras] [intervalo de quadro-chave]
+----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "delta-ring.h"
+
+static long total_amostras = 4000000;
+static unsigned intervalo = 64;
+static int32_t *sinal;
+static uint8_t *memoria;
+static unsigned tamanho_memoria;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned proximo(unsigned *semente) {
+    *semente = *semente * 1103515245u + 12345u;
+    return *semente >> 16;
+}
+
+static void gerar(const char *tipo) {
+    unsigned semente = 99;
+    int32_t valor = 2048;
+    for (long i = 0; i < total_amostras; i++) {
+        if (tipo[0] == 'a') {
+            valor += (int32_t)(proximo(&semente) % 9) - 4;
+        } else if (tipo[0] == 's') {
+            valor = (int32_t)(2048 + 1500 * sin(i * 0.001)) + (int32_t)(proximo(&semente) % 5) - 2;
+        } else {
+            if (i % 500 == 0) {
+                valor = (int32_t)(proximo(&semente) % 100000);
+            }
+            valor += (int32_t)(proximo(&semente) % 3) - 1;
+        }
+        sinal[i] = valor;
+    }
+}
+
+static void medir(const char *tipo) {
+    gerar(tipo);
+
+    DeltaRing ring;
+    initializeDeltaRing(&ring, memoria, tamanho_memoria, intervalo);
+    double inicio = agora();
+    for (long i = 0; i < total_amostras; i++) {
+        deltaInsertItem(&ring, sinal[i]);
+    }
+    double codificar = agora() - inicio;
+    double bytes = deltaBytesUsed(&ring);
+
+    int32_t item;
+    long erros = 0, i = 0;
+    inicio = agora();
+    while (deltaRemoveItem(&ring, &item)) {
+        erros += item != sinal[i++];
+    }
+    double decodificar = agora() - inicio;
+
+    printf("%-8s %5.2f bytes/amostra  razão %4.2fx  codifica %7.1f M/s  decodifica %7.1f M/s  %s\n",
+           tipo, bytes / total_amostras, 4.0 * total_amostras / bytes, total_amostras / codificar / 1e6,
+           total_amostras / decodificar / 1e6, erros == 0 && i == total_amostras ? "ok" : "ERRO");
+}
+
+static void medirReferencia(void) {
+    CircularBuffer *buf = initializeBufferPow2((int)total_amostras);
+    double inicio = agora();
+    for (long i = 0; i < total_amostras; i++) {
+        insertItemPow2(buf, sinal[i]);
+    }
+    double inserir = agora() - inicio;
+    int item;
+    long long soma = 0;
+    inicio = agora();
+    while (removeItemPow2(buf, &item) == BUFFER_OK) {
+        soma += item;
+    }
+    double remover = agora() - inicio;
+    printf("%-8s %5.2f bytes/amostra  razão %4.2fx  insere   %7.1f M/s  remove     %7.1f M/s  (soma %lld)\n",
+           "int", 4.0, 1.0, total_amostras / inserir / 1e6, total_amostras / remover / 1e6, soma);
+    releaseBuffer(buf);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_amostras = atol(argv[1]);
+    if (argc > 2) intervalo = (unsigned)atoi(argv[2]);
+    sinal = malloc(total_amostras * sizeof(int32_t));
+    tamanho_memoria = 1;
+    while (tamanho_memoria < (unsigned)total_amostras * DELTA_MAX_RECORD) {
+        tamanho_memoria <<= 1;
+    }
+    memoria = malloc(tamanho_memoria);
+
+    printf("amostras=%ld quadro-chave a cada %u\n", total_amostras, intervalo);
+    medir("adc");
+    medir("senoide");
+    medir("degraus");
+    medirReferencia();
+    free(memoria);
+    free(sinal);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*--------------------------------------------------------------------------
+Benchmark: esvaziamento de um CircularBuffer para um arquivo.
+
+  elemento   removeItem por item para um vetor temporário + write
+             (como é feito hoje);
+  writev     drainBuffer: os dois trechos do buffer direto no writev;
+  io_uring   uringDrainSubmit/uringDrainWait com gravações assíncronas.
+
+O produtor insere blocos de BLOCO itens e o buffer é esvaziado quando
+não cabe o próximo bloco. Mostra MB/s e syscalls por MB gravado.
+
+Compilação:  gcc -O2 bench-drain.c -o bench-drain
+Uso:         ./bench-drain [MB] [arquivo]
+----------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "BufferCircular.h"
+#include "ring-drain.h"
+
+#define CAPACIDADE (1 << 16)
+#define BLOCO      (CAPACIDADE / 4)
+#define TEMPORARIO 4096
+
+static long total_itens;
+static const char *caminho = "/tmp/bench-drain.out";
+static int origem[BLOCO];
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int abrirDestino(void) {
+    int fd = open(caminho, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(caminho);
+        exit(1);
+    }
+    return fd;
+}
+
+static void relatar(const char *nome, double tempo, unsigned long syscalls, int fd) {
+    double mb = total_itens * sizeof(int) / 1e6;
+    struct stat st;
+    fstat(fd, &st);
+    int ok = !S_ISREG(st.st_mode) || st.st_size == (off_t)(total_itens * sizeof(int));
+    printf("%-10s %9.1f MB/s  %8.2f syscalls/MB  %s\n", nome, mb / tempo, syscalls / mb,
+           ok ? "ok" : "TAMANHO INCORRETO");
+}
+
+static void medirElemento(void) {
+    static int temporario[TEMPORARIO];
+    int fd = abrirDestino();
+    CircularBuffer *buf = initializeBuffer(CAPACIDADE);
+    unsigned long syscalls = 0;
+    double inicio = agora();
+    for (long enviados = 0; enviados < total_itens; enviados += BLOCO) {
+        insertItems(buf, origem, BLOCO);
+        if (enviados + BLOCO >= total_itens || CAPACIDADE - bufferCount(buf) < BLOCO) {
+            while (!isBufferEmpty(buf)) {
+                int n = 0;
+                while (n < TEMPORARIO && removeItem(buf, &temporario[n]) == BUFFER_OK) {
+                    n++;
+                }
+                if (write(fd, temporario, n * sizeof(int)) < 0) {
+                    perror("write");
+                    exit(1);
+                }
+                syscalls++;
+            }
+        }
+    }
+    relatar("elemento", agora() - inicio, syscalls, fd);
+    releaseBuffer(buf);
+    close(fd);
+}
+
+static void medirWritev(void) {
+    int fd = abrirDestino();
+    CircularBuffer *buf = initializeBuffer(CAPACIDADE);
+    BufferDrain d;
+    initializeDrain(&d, fd);
+    double inicio = agora();
+    for (long enviados = 0; enviados < total_itens; enviados += BLOCO) {
+        insertItems(buf, origem, BLOCO);
+        if (enviados + BLOCO >= total_itens || CAPACIDADE - bufferCount(buf) < BLOCO) {
+            while (!isBufferEmpty(buf)) {
+                if (drainBuffer(&d, buf) < 0) {
+                    perror("writev");
+                    exit(1);
+                }
+            }
+        }
+    }
+    relatar("writev", agora() - inicio, d.syscalls, fd);
+    releaseBuffer(buf);
+    close(fd);
+}
+
+static void medirUring(void) {
+#ifdef URING_DRAIN_DEPTH
+    int fd = abrirDestino();
+    CircularBuffer *buf = initializeBuffer(CAPACIDADE);
+    UringDrain u;
+    if (uringDrainInit(&u, fd, 0) != 0) {
+        printf("io_uring   indisponível neste kernel\n");
+        close(fd);
+        releaseBuffer(buf);
+        return;
+    }
+    double inicio = agora();
+    for (long enviados = 0; enviados < total_itens; enviados += BLOCO) {
+        /* Buffer sem espaço: submete o que falta e espera a gravação mais
+           antiga na mesma syscall; as demais continuam em voo */
+        while (CAPACIDADE - bufferCount(buf) < BLOCO) {
+            uringDrainSubmit(&u, buf);
+            if (uringDrainWait(&u, buf, 1) != 0) {
+                printf("io_uring: erro %d\n", u.error);
+                exit(1);
+            }
+        }
+        insertItems(buf, origem, BLOCO);
+        uringDrainReap(&u, buf);
+    }
+    uringDrainSubmit(&u, buf);
+    while (u.count || u.queued) {
+        uringDrainWait(&u, buf, u.count);
+    }
+    relatar("io_uring", agora() - inicio, u.syscalls, fd);
+    uringDrainRelease(&u);
+    releaseBuffer(buf);
+    close(fd);
+#else
+    printf("io_uring   não compilado (sem <linux/io_uring.h>)\n");
+#endif
+}
+
+int main(int argc, char **argv) {
+    long mb = 256;
+    if (argc > 1) mb = atol(argv[1]);
+    if (argc > 2) caminho = argv[2];
+    total_itens = mb * 1000000 / sizeof(int) / BLOCO * BLOCO;
+    for (int i = 0; i < BLOCO; i++) {
+        origem[i] = i;
+    }
+
+    printf("dados=%ld MB capacidade=%d itens bloco=%d itens destino=%s\n", mb, CAPACIDADE, BLOCO, caminho);
+    medirElemento();
+    medirWritev();
+    medirUring();
+    unlink(caminho);
+    return 0;
+}
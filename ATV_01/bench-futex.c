@@ -0,0 +1,183 @@
+/*--------------------------------------------------------------------------
+Benchmark: espera do consumidor em um buffer circular.
+
+  polling   SpscBuffer testado em laço, como a tarefa_8 faz no RTOS;
+  mutex     CircularBuffer protegido por pthread_mutex + pthread_cond;
+  futex     BlockingBuffer (blocking-buffer.h).
+
+O produtor envia RAJADA itens e dorme PAUSA_US microssegundos, imitando
+dados que chegam aos poucos. Mostra o tempo de CPU do processo (getrusage,
+usuário + sistema), a latência entre inserir e remover cada item (média e
+p99) e, no futex, quantas syscalls de espera/despertar foram feitas.
+
+Compilação:  gcc -O2 -pthread bench-futex.c -o bench-futex
+Uso:         ./bench-futex [itens] [pausa em us]
+----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "blocking-buffer.h"
+#include "spsc-buffer.h"
+
+#define CAPACIDADE 1024
+#define RAJADA     16
+
+static int total_itens = 200000;
+static int pausa_us = 50;
+static double *enviado;   // Instante de inserção de cada item
+static double *latencia;  // Latência de cada item
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double tempoCpu(void) {
+    struct rusage r;
+    getrusage(RUSAGE_SELF, &r);
+    return r.ru_utime.tv_sec + r.ru_utime.tv_usec * 1e-6 + r.ru_stime.tv_sec + r.ru_stime.tv_usec * 1e-6;
+}
+
+static void pausar(int i) {
+    if ((i + 1) % RAJADA == 0) {
+        struct timespec ts = {0, pausa_us * 1000L};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static int comparar(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void relatar(const char *nome, double cpu, double parede, const char *extra) {
+    double soma = 0;
+    for (int i = 0; i < total_itens; i++) soma += latencia[i];
+    qsort(latencia, total_itens, sizeof(double), comparar);
+    printf("%-8s cpu %7.1f ms  parede %7.1f ms  latência média %8.2f us  p99 %8.2f us  %s\n",
+           nome, cpu * 1e3, parede * 1e3, soma / total_itens * 1e6,
+           latencia[(int)(total_itens * 0.99)] * 1e6, extra);
+}
+
+/* ---- polling ---- */
+static SpscBuffer *spsc;
+
+static void *consumidorPolling(void *arg) {
+    (void)arg;
+    int item;
+    for (int i = 0; i < total_itens; i++) {
+        while (!spscRemoveItem(spsc, &item)) {
+        }
+        latencia[item] = agora() - enviado[item];
+    }
+    return NULL;
+}
+
+static void medirPolling(void) {
+    spsc = initializeSpscBuffer(CAPACIDADE);
+    pthread_t t;
+    double cpu = tempoCpu(), inicio = agora();
+    pthread_create(&t, NULL, consumidorPolling, NULL);
+    for (int i = 0; i < total_itens; i++) {
+        enviado[i] = agora();
+        while (!spscInsertItem(spsc, i)) {
+        }
+        pausar(i);
+    }
+    pthread_join(t, NULL);
+    relatar("polling", tempoCpu() - cpu, agora() - inicio, "");
+    releaseSpscBuffer(spsc);
+}
+
+/* ---- mutex + condvar ---- */
+static CircularBuffer *buf;
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t naoVazio = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t naoCheio = PTHREAD_COND_INITIALIZER;
+
+static void *consumidorMutex(void *arg) {
+    (void)arg;
+    int item;
+    for (int i = 0; i < total_itens; i++) {
+        pthread_mutex_lock(&trava);
+        while (removeItem(buf, &item) != BUFFER_OK) {
+            pthread_cond_wait(&naoVazio, &trava);
+        }
+        pthread_cond_signal(&naoCheio);
+        pthread_mutex_unlock(&trava);
+        latencia[item] = agora() - enviado[item];
+    }
+    return NULL;
+}
+
+static void medirMutex(void) {
+    buf = initializeBuffer(CAPACIDADE);
+    pthread_t t;
+    double cpu = tempoCpu(), inicio = agora();
+    pthread_create(&t, NULL, consumidorMutex, NULL);
+    for (int i = 0; i < total_itens; i++) {
+        enviado[i] = agora();
+        pthread_mutex_lock(&trava);
+        while (insertItem(buf, i) != BUFFER_OK) {
+            pthread_cond_wait(&naoCheio, &trava);
+        }
+        pthread_cond_signal(&naoVazio);
+        pthread_mutex_unlock(&trava);
+        pausar(i);
+    }
+    pthread_join(t, NULL);
+    relatar("mutex", tempoCpu() - cpu, agora() - inicio, "");
+    releaseBuffer(buf);
+}
+
+/* ---- futex ---- */
+static BlockingBuffer *bloq;
+
+static void *consumidorFutex(void *arg) {
+    (void)arg;
+    int item;
+    for (int i = 0; i < total_itens; i++) {
+        blockingRemoveItem(bloq, &item, -1);
+        latencia[item] = agora() - enviado[item];
+    }
+    return NULL;
+}
+
+static void medirFutex(void) {
+    bloq = initializeBlockingBuffer(CAPACIDADE, CAPACIDADE / 4);
+    pthread_t t;
+    double cpu = tempoCpu(), inicio = agora();
+    pthread_create(&t, NULL, consumidorFutex, NULL);
+    for (int i = 0; i < total_itens; i++) {
+        enviado[i] = agora();
+        blockingInsertItem(bloq, i, -1);
+        pausar(i);
+    }
+    pthread_join(t, NULL);
+    char extra[64];
+    snprintf(extra, sizeof(extra), "wait %lu wake %lu", (unsigned long)bloq->waitCalls,
+             (unsigned long)bloq->wakeCalls);
+    relatar("futex", tempoCpu() - cpu, agora() - inicio, extra);
+    releaseBlockingBuffer(bloq);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_itens = atoi(argv[1]);
+    if (argc > 2) pausa_us = atoi(argv[2]);
+    enviado = malloc(total_itens * sizeof(double));
+    latencia = malloc(total_itens * sizeof(double));
+
+    printf("itens=%d rajada=%d pausa=%d us capacidade=%d\n", total_itens, RAJADA, pausa_us, CAPACIDADE);
+    medirPolling();
+    medirMutex();
+    medirFutex();
+    free(enviado);
+    free(latencia);
+    return 0;
+}
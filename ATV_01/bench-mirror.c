@@ -0,0 +1,128 @@
+/*--------------------------------------------------------------------------
+Benchmark: varredura do conteúdo do buffer atravessando o fim de 'data'.
+
+O buffer é preenchido de modo que os itens comecem no meio de 'data' e
+continuem no início (janela atravessando a volta). Cada medição conta
+quantos itens são iguais a ALVO:
+
+  índice com %      data[(rear + i) % capacity], como um consumidor faz
+                    hoje sem acesso direto à memória;
+  dois trechos      peekSpan + o restante a partir do início;
+  espelhado         um único peekSpan de um buffer de mirror-buffer.h;
+  espelhado memchr  procura do byte marcador com memchr sobre a janela.
+
+Compilação:  gcc -O2 bench-mirror.c -o bench-mirror
+Uso:         ./bench-mirror [itens] [repetições]
+----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "mirror-buffer.h"
+
+#define ALVO      7
+#define MARCADOR  0x7F7F7F7F
+
+/* Impede o compilador de reaproveitar a varredura entre repetições */
+#define BARREIRA() __asm__ volatile("" ::: "memory")
+
+static int capacidade = 1 << 20;
+static int repeticoes = 50;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Deixa 'ocupado' itens começando na metade de 'data' */
+static int preencher(CircularBuffer *buf) {
+    int item;
+    int ocupado = buf->capacity - 1;
+    for (int i = 0; i < buf->capacity / 2; i++) {
+        insertItem(buf, 0);
+        removeItem(buf, &item);
+    }
+    for (int i = 0; i < ocupado - 1; i++) {
+        insertItem(buf, i % 100);
+    }
+    insertItem(buf, MARCADOR);
+    return ocupado;
+}
+
+static long contarFaixa(const int *p, int n) {
+    long c = 0;
+    for (int i = 0; i < n; i++) {
+        c += p[i] == ALVO;
+    }
+    return c;
+}
+
+static void relatar(const char *nome, double tempo, long bytes, long resultado) {
+    printf("%-18s %8.2f GB/s  (resultado %ld)\n", nome, bytes * (double)repeticoes / tempo / 1e9, resultado);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) capacidade = atoi(argv[1]);
+    if (argc > 2) repeticoes = atoi(argv[2]);
+
+    CircularBuffer *normal = initializeBuffer(capacidade);
+    CircularBuffer *espelhado = initializeBufferMirrored(capacidade);
+    if (espelhado == NULL) {
+        printf("erro: não foi possível criar o buffer espelhado\n");
+        return 1;
+    }
+    /* Mesma capacidade nos dois para comparar a mesma janela */
+    releaseBuffer(normal);
+    normal = initializeBuffer(espelhado->capacity);
+
+    int ocupado = preencher(normal);
+    preencher(espelhado);
+    long bytes = (long)ocupado * sizeof(int);
+    printf("capacidade=%d itens=%d (%.1f MB) repetições=%d\n", normal->capacity, ocupado,
+           bytes / 1e6, repeticoes);
+
+    long resultado = 0;
+    double inicio = agora();
+    for (int r = 0; r < repeticoes; r++) {
+        BARREIRA();
+        resultado = 0;
+        for (int i = 0; i < ocupado; i++) {
+            resultado += normal->data[(normal->rear + i) % normal->capacity] == ALVO;
+        }
+    }
+    relatar("índice com %", agora() - inicio, bytes, resultado);
+
+    inicio = agora();
+    for (int r = 0; r < repeticoes; r++) {
+        BARREIRA();
+        BufferSpan span = peekSpan(normal);
+        resultado = contarFaixa(span.ptr, span.len);
+        resultado += contarFaixa(normal->data, ocupado - span.len);
+    }
+    relatar("dois trechos", agora() - inicio, bytes, resultado);
+
+    inicio = agora();
+    for (int r = 0; r < repeticoes; r++) {
+        BARREIRA();
+        BufferSpan span = peekSpan(espelhado);
+        resultado = contarFaixa(span.ptr, span.len);
+    }
+    relatar("espelhado", agora() - inicio, bytes, resultado);
+
+    inicio = agora();
+    for (int r = 0; r < repeticoes; r++) {
+        BARREIRA();
+        BufferSpan span = peekSpan(espelhado);
+        const char *achado = memchr(span.ptr, 0x7F, (size_t)span.len * sizeof(int));
+        resultado = achado ? (long)((const int *)achado - span.ptr) : -1;
+    }
+    relatar("espelhado memchr", agora() - inicio, bytes, resultado);
+
+    releaseBuffer(normal);
+    releaseBuffer(espelhado);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*--------------------------------------------------------------------------
+Benchmark de escalabilidade da fila MPMC (mpmc-queue.h).
+
+Para n = 1, 2, 4, ... até o máximo pedido, executa n produtores e n
+consumidores sobre a mesma fila e mostra a vazão total e a latência de
+inserção (do início da tentativa até o sucesso, incluindo as esperas
+com a fila cheia) nos percentis 50, 99 e 99,9. A latência é amostrada a
+cada AMOSTRAGEM operações para não dominar a medição.
+
+Compilação:  gcc -O2 -pthread bench-mpmc.c -o bench-mpmc
+Uso:         ./bench-mpmc [máximo de threads por lado] [itens por produtor]
+
+Com a fila cheia/vazia as threads cedem o processador (sched_yield).
+Os números só medem escalabilidade de fato com núcleos livres para
+todas as 2n threads.
+----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mpmc-queue.h"
+
+#define CAPACIDADE 4096
+#define AMOSTRAGEM 64
+
+static MpmcQueue *fila;
+static long itens_por_produtor = 1000000;
+
+typedef struct {
+    pthread_t thread;
+    int id;
+    long quantidade;       // Itens a remover (consumidor)
+    long long soma;        // Soma dos itens removidos (consumidor)
+    double *latencias;     // Amostras de latência em ns (produtor)
+    long amostras;
+} Trabalhador;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *produtor(void *arg) {
+    Trabalhador *t = (Trabalhador *)arg;
+    int base = t->id * (int)itens_por_produtor;
+    for (long i = 0; i < itens_por_produtor; i++) {
+        int medir = (i % AMOSTRAGEM) == 0;
+        double inicio = medir ? agora() : 0;
+        while (!mpmcInsertItem(fila, base + (int)i)) {
+            sched_yield();
+        }
+        if (medir) {
+            t->latencias[t->amostras++] = (agora() - inicio) * 1e9;
+        }
+    }
+    return NULL;
+}
+
+static void *consumidor(void *arg) {
+    Trabalhador *t = (Trabalhador *)arg;
+    int item;
+    for (long i = 0; i < t->quantidade; i++) {
+        while (!mpmcRemoveItem(fila, &item)) {
+            sched_yield();
+        }
+        t->soma += item;
+    }
+    return NULL;
+}
+
+static int comparar(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void executar(int n) {
+    Trabalhador *prod = calloc(n, sizeof(Trabalhador));
+    Trabalhador *cons = calloc(n, sizeof(Trabalhador));
+    long total = itens_por_produtor * n;
+    long amostrasPorProdutor = itens_por_produtor / AMOSTRAGEM + 1;
+
+    fila = initializeMpmcQueue(CAPACIDADE);
+
+    double inicio = agora();
+    for (int i = 0; i < n; i++) {
+        cons[i].id = i;
+        cons[i].quantidade = total / n + (i < total % n ? 1 : 0);
+        pthread_create(&cons[i].thread, NULL, consumidor, &cons[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        prod[i].id = i;
+        prod[i].latencias = malloc(amostrasPorProdutor * sizeof(double));
+        pthread_create(&prod[i].thread, NULL, produtor, &prod[i]);
+    }
+    for (int i = 0; i < n; i++) pthread_join(prod[i].thread, NULL);
+    for (int i = 0; i < n; i++) pthread_join(cons[i].thread, NULL);
+    double tempo = agora() - inicio;
+
+    long long soma = 0, esperado = (long long)total * (total - 1) / 2;
+    for (int i = 0; i < n; i++) soma += cons[i].soma;
+
+    long nAmostras = 0;
+    double *todas = malloc(amostrasPorProdutor * n * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        for (long j = 0; j < prod[i].amostras; j++) todas[nAmostras++] = prod[i].latencias[j];
+        free(prod[i].latencias);
+    }
+    qsort(todas, nAmostras, sizeof(double), comparar);
+
+    printf("%3d x %-3d %10.2f Mops/s %10.0f %10.0f %10.0f  %s\n", n, n,
+           total / tempo / 1e6, todas[nAmostras / 2], todas[nAmostras * 99 / 100],
+           todas[nAmostras * 999 / 1000], soma == esperado ? "ok" : "SOMA INCORRETA");
+
+    free(todas);
+    free(prod);
+    free(cons);
+    releaseMpmcQueue(fila);
+}
+
+int main(int argc, char **argv) {
+    int maximo = 8;
+    if (argc > 1) maximo = atoi(argv[1]);
+    if (argc > 2) itens_por_produtor = atol(argv[2]);
+
+    printf("capacidade=%d itens por produtor=%ld núcleos=%ld\n", CAPACIDADE,
+           itens_por_produtor, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-9s %17s %10s %10s %10s\n", "prod x cons", "vazão", "p50 ns", "p99 ns", "p99.9 ns");
+    for (int n = 1; n <= maximo; n *= 2) {
+        executar(n);
+    }
+    return 0;
+}
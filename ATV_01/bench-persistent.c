@@ -0,0 +1,153 @@
+/*--------------------------------------------------------------------------
+Benchmark: vazão entre dois processos pelo buffer persistente
+(persistent-ring.h) contra um pipe.
+
+O processo pai produz N inteiros em blocos e o filho os consome e confere
+a soma. Com o buffer persistente os dados passam pela memória mapeada do
+arquivo (sem syscalls por bloco); com o pipe cada bloco custa um write e
+um read.
+
+Compilação:  gcc -O2 bench-persistent.c -o bench-persistent
+Uso:         ./bench-persistent [itens] [arquivo] [itens por bloco]
+
+O arquivo padrão fica em /dev/shm para medir o compartilhamento em si;
+use um caminho em disco para incluir o write-back do kernel.
+----------------------------------------------------------------------------*/
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "persistent-ring.h"
+
+#define MAX_BLOCO 4096
+
+static long total_itens = 50000000;
+static int bloco = 256;
+static const char *caminho = "/dev/shm/bench-persistent.ring";
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long long somaEsperada(void) {
+    long long s = 0;
+    for (long i = 0; i < total_itens; i++) {
+        s += (int)i;
+    }
+    return s;
+}
+
+static void relatar(const char *nome, double tempo, int ok) {
+    printf("%-12s %8.3f s  %9.1f MB/s  %s\n", nome, tempo,
+           total_itens * sizeof(int) / tempo / 1e6, ok ? "ok" : "SOMA INCORRETA");
+}
+
+static void medirPersistente(void) {
+    PersistentRing ring;
+    unlink(caminho);
+    if (openPersistentRing(&ring, caminho, 1 << 16) == PERSISTENT_ERROR) {
+        printf("erro: não foi possível abrir %s\n", caminho);
+        return;
+    }
+
+    double inicio = agora();
+    pid_t filho = fork();
+    if (filho == 0) {
+        static int dst[MAX_BLOCO];
+        long long soma = 0;
+        long recebidos = 0;
+        while (recebidos < total_itens) {
+            int n = persistentRemoveItems(&ring, dst, bloco);
+            if (n == 0) {
+                sched_yield();
+                continue;
+            }
+            for (int i = 0; i < n; i++) soma += dst[i];
+            recebidos += n;
+        }
+        _exit(soma == somaEsperada() ? 0 : 1);
+    }
+
+    static int src[MAX_BLOCO];
+    long enviados = 0;
+    while (enviados < total_itens) {
+        int n = bloco;
+        if (n > total_itens - enviados) n = (int)(total_itens - enviados);
+        for (int i = 0; i < n; i++) src[i] = (int)(enviados + i);
+        int k = 0;
+        while (k < n) {
+            int m = persistentInsertItems(&ring, src + k, n - k);
+            if (m == 0) sched_yield();
+            k += m;
+        }
+        enviados += n;
+    }
+    int estado;
+    waitpid(filho, &estado, 0);
+    relatar("persistente", agora() - inicio, WIFEXITED(estado) && WEXITSTATUS(estado) == 0);
+    closePersistentRing(&ring);
+    unlink(caminho);
+}
+
+static void medirPipe(void) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        printf("erro: pipe\n");
+        return;
+    }
+
+    double inicio = agora();
+    pid_t filho = fork();
+    if (filho == 0) {
+        static int dst[MAX_BLOCO];
+        long long soma = 0;
+        long bytes = 0, total = total_itens * (long)sizeof(int);
+        close(fds[1]);
+        while (bytes < total) {
+            ssize_t n = read(fds[0], (char *)dst, bloco * sizeof(int));
+            if (n <= 0) break;
+            /* read pode devolver um número de bytes que não é múltiplo de 4 */
+            size_t inteiros = (size_t)n / sizeof(int), resto = (size_t)n % sizeof(int);
+            if (resto) {
+                ssize_t r = read(fds[0], (char *)dst + n, sizeof(int) - resto);
+                if (r > 0) { n += r; inteiros++; }
+            }
+            for (size_t i = 0; i < inteiros; i++) soma += dst[i];
+            bytes += n;
+        }
+        _exit(soma == somaEsperada() ? 0 : 1);
+    }
+
+    close(fds[0]);
+    static int src[MAX_BLOCO];
+    long enviados = 0;
+    while (enviados < total_itens) {
+        int n = bloco;
+        if (n > total_itens - enviados) n = (int)(total_itens - enviados);
+        for (int i = 0; i < n; i++) src[i] = (int)(enviados + i);
+        if (write(fds[1], src, n * sizeof(int)) != (ssize_t)(n * sizeof(int))) break;
+        enviados += n;
+    }
+    close(fds[1]);
+    int estado;
+    waitpid(filho, &estado, 0);
+    relatar("pipe", agora() - inicio, WIFEXITED(estado) && WEXITSTATUS(estado) == 0);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_itens = atol(argv[1]);
+    if (argc > 2) caminho = argv[2];
+    if (argc > 3) bloco = atoi(argv[3]);
+    if (bloco > MAX_BLOCO) bloco = MAX_BLOCO;
+
+    printf("itens=%ld bloco=%d arquivo=%s\n", total_itens, bloco, caminho);
+    medirPersistente();
+    medirPipe();
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------------
+Microbenchmark: custo por operação do CircularBuffer no modo módulo
+(insertItem/removeItem, com '%' a cada elemento) contra o modo potência
+de dois (insertItemPow2/removeItemPow2, com índices livres e máscara).
+
+O laço mantém o buffer pela metade e alterna uma inserção e uma remoção,
+de forma que os índices dão várias voltas. Em x86 o resultado também é
+mostrado em ciclos (rdtsc).
+
+Compilação:  gcc -O2 bench-pow2.c -o bench-pow2
+Uso:         ./bench-pow2 [operações] [capacidade]
+
+A capacidade padrão (1000) não é potência de dois, para que o modo
+módulo faça uma divisão real; o modo potência de dois a arredonda para
+1024.
+----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TEM_RDTSC 1
+#endif
+
+#include "BufferCircular.h"
+
+static long total_ops = 50000000;
+static int capacidade = 1000;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long ciclos(void) {
+#ifdef TEM_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void relatar(const char *nome, double tempo, unsigned long long c, long long soma) {
+    printf("%-14s %8.3f s  %6.2f ns/op", nome, tempo, tempo * 1e9 / total_ops);
+#ifdef TEM_RDTSC
+    printf("  %6.2f ciclos/op", (double)c / total_ops);
+#else
+    (void)c;
+#endif
+    printf("  (soma %lld)\n", soma);
+}
+
+static double medirModulo(void) {
+    CircularBuffer *buf = initializeBuffer(capacidade);
+    long long soma = 0;
+    int item = 0;
+    for (int i = 0; i < capacidade / 2; i++) {
+        insertItem(buf, i);
+    }
+
+    double inicio = agora();
+    unsigned long long c0 = ciclos();
+    for (long i = 0; i < total_ops; i++) {
+        insertItem(buf, (int)i);
+        removeItem(buf, &item);
+        soma += item;
+    }
+    unsigned long long c1 = ciclos();
+    double tempo = agora() - inicio;
+
+    relatar("modulo", tempo, c1 - c0, soma);
+    releaseBuffer(buf);
+    return tempo;
+}
+
+static double medirPow2(void) {
+    CircularBuffer *buf = initializeBufferPow2(capacidade);
+    long long soma = 0;
+    int item = 0;
+    for (int i = 0; i < capacidade / 2; i++) {
+        insertItemPow2(buf, i);
+    }
+
+    double inicio = agora();
+    unsigned long long c0 = ciclos();
+    for (long i = 0; i < total_ops; i++) {
+        insertItemPow2(buf, (int)i);
+        removeItemPow2(buf, &item);
+        soma += item;
+    }
+    unsigned long long c1 = ciclos();
+    double tempo = agora() - inicio;
+
+    relatar("potencia de 2", tempo, c1 - c0, soma);
+    releaseBuffer(buf);
+    return tempo;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_ops = atol(argv[1]);
+    if (argc > 2) capacidade = atoi(argv[2]);
+
+    printf("operações=%ld (1 inserção + 1 remoção cada) capacidade=%d\n", total_ops, capacidade);
+    double base = medirModulo();
+    double novo = medirPow2();
+    printf("ganho: %.2fx\n", base / novo);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*--------------------------------------------------------------------------
+Benchmark: buffer redimensionável (resizable-ring.h) contra um buffer
+fixo dimensionado para o pior caso (initializeBufferPow2 + insertItemPow2).
+
+Carga em rajadas: a cada ciclo o produtor insere uma rajada e o
+consumidor esvazia o buffer. Uma em cada RARA rajadas tem MAXIMO itens,
+as demais têm COMUM itens. Mostra o custo amortizado por inserção, o
+pico de memória dos dados e a média da memória medida ao fim de cada
+rajada.
+
+Em seguida roda produtor e consumidor em threads separadas e confere a
+soma, exercitando a passagem de bloco com leitura concorrente.
+
+Compilação:  gcc -O2 -pthread bench-resize.c -o bench-resize
+Uso:         ./bench-resize [ciclos]
+----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "resizable-ring.h"
+
+#define MINIMO  64
+#define MAXIMO  (1 << 18)
+#define COMUM   48
+#define RARA    1000
+
+static long ciclos = 20000;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int rajada(long ciclo) {
+    return ciclo % RARA == RARA - 1 ? MAXIMO : COMUM;
+}
+
+static void relatar(const char *nome, double tempo, long itens, size_t pico, double media, long long soma) {
+    printf("%-14s %6.2f ns/inserção  pico %6zu KiB  média %8.1f KiB  soma %lld\n", nome,
+           tempo / itens * 1e9, pico / 1024, media / 1024, soma);
+}
+
+static void medirFixo(void) {
+    CircularBuffer *buf = initializeBufferPow2(MAXIMO);
+    long long soma = 0;
+    long itens = 0;
+    int item;
+    double inicio = agora();
+    for (long c = 0; c < ciclos; c++) {
+        int n = rajada(c);
+        for (int i = 0; i < n; i++) {
+            insertItemPow2(buf, i);
+        }
+        while (removeItemPow2(buf, &item) == BUFFER_OK) {
+            soma += item;
+        }
+        itens += n;
+    }
+    size_t bytes = (size_t)buf->capacity * sizeof(int);
+    relatar("fixo", agora() - inicio, itens, bytes, (double)bytes, soma);
+    releaseBuffer(buf);
+}
+
+static void medirRedimensionavel(void) {
+    ResizableRing r;
+    initializeResizableRing(&r, MINIMO, MAXIMO);
+    long long soma = 0;
+    long itens = 0;
+    double memoria = 0;
+    int item;
+    double inicio = agora();
+    for (long c = 0; c < ciclos; c++) {
+        int n = rajada(c);
+        for (int i = 0; i < n; i++) {
+            resizableInsertItem(&r, i);
+        }
+        memoria += r.bytes;
+        while (resizableRemoveItem(&r, &item)) {
+            soma += item;
+        }
+        itens += n;
+    }
+    double tempo = agora() - inicio;
+    relatar("redimensionável", tempo, itens, r.peakBytes, memoria / ciclos, soma);
+    printf("%-14s crescimentos %u  reduções %u  descartes %u\n", "", r.grows, r.shrinks, r.drops);
+    releaseResizableRing(&r);
+}
+
+/* ---- produtor e consumidor concorrentes ---- */
+static ResizableRing compartilhado;
+static long total_concorrente;
+
+static void *consumidor(void *arg) {
+    long long *soma = (long long *)arg;
+    int item;
+    for (long i = 0; i < total_concorrente; i++) {
+        while (!resizableRemoveItem(&compartilhado, &item)) {
+            sched_yield();
+        }
+        *soma += item;
+    }
+    return NULL;
+}
+
+static void medirConcorrente(void) {
+    initializeResizableRing(&compartilhado, MINIMO, MAXIMO);
+    long long soma = 0, esperada = 0;
+    pthread_t t;
+    total_concorrente = 0;
+    for (long c = 0; c < ciclos; c++) {
+        total_concorrente += rajada(c);
+    }
+    double inicio = agora();
+    pthread_create(&t, NULL, consumidor, &soma);
+    for (long c = 0; c < ciclos; c++) {
+        int n = rajada(c);
+        for (int i = 0; i < n; i++) {
+            while (!resizableInsertItem(&compartilhado, i)) {
+                sched_yield();
+            }
+            esperada += i;
+        }
+    }
+    pthread_join(t, NULL);
+    printf("%-14s %6.2f ns/item  crescimentos %u  reduções %u  %s\n", "concorrente",
+           (agora() - inicio) / total_concorrente * 1e9, compartilhado.grows, compartilhado.shrinks,
+           soma == esperada ? "ok" : "SOMA INCORRETA");
+    releaseResizableRing(&compartilhado);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) ciclos = atol(argv[1]);
+    printf("ciclos=%ld rajada comum=%d rara=%d (1 em %d) mínimo=%d\n", ciclos, COMUM, MAXIMO, RARA, MINIMO);
+    medirFixo();
+    medirRedimensionavel();
+    medirConcorrente();
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*--------------------------------------------------------------------------
+Benchmark: vazão entre duas threads (um produtor, um consumidor).
+
+Compara o SpscBuffer (spsc-buffer.h) com o CircularBuffer original
+(BufferCircular.h) protegido por um pthread_mutex.
+
+Compilação:  gcc -O2 -pthread bench-spsc.c -o bench-spsc
+Uso:         ./bench-spsc [itens] [capacidade]
+
+Quando o buffer está cheio/vazio a thread cede o processador
+(sched_yield), para que o resultado seja significativo também em
+máquinas com um único núcleo.
+----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "spsc-buffer.h"
+
+static long total_itens = 10000000;
+static int capacidade = 1024;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ---------------- SPSC sem trava ---------------- */
+
+static SpscBuffer *spsc;
+
+static void *produtorSpsc(void *arg) {
+    (void)arg;
+    for (long i = 0; i < total_itens; i++) {
+        while (!spscInsertItem(spsc, (int)i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumidorSpsc(void *arg) {
+    long long *soma = (long long *)arg;
+    int item;
+    for (long i = 0; i < total_itens; i++) {
+        while (!spscRemoveItem(spsc, &item)) {
+            sched_yield();
+        }
+        *soma += item;
+    }
+    return NULL;
+}
+
+/* ---------------- CircularBuffer + mutex ---------------- */
+
+static CircularBuffer *circular;
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+static void *produtorMutex(void *arg) {
+    (void)arg;
+    for (long i = 0; i < total_itens; i++) {
+        int inserido = 0;
+        while (!inserido) {
+            pthread_mutex_lock(&trava);
+            if (!isBufferFull(circular)) {
+                insertItem(circular, (int)i);
+                inserido = 1;
+            }
+            pthread_mutex_unlock(&trava);
+            if (!inserido) sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumidorMutex(void *arg) {
+    long long *soma = (long long *)arg;
+    for (long i = 0; i < total_itens; i++) {
+        int removido = 0;
+        while (!removido) {
+            pthread_mutex_lock(&trava);
+            if (!isBufferEmpty(circular)) {
+                int item;
+                removeItem(circular, &item);
+                *soma += item;
+                removido = 1;
+            }
+            pthread_mutex_unlock(&trava);
+            if (!removido) sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static double executar(const char *nome, void *(*produtor)(void *),
+                       void *(*consumidor)(void *)) {
+    pthread_t tp, tc;
+    long long soma = 0;
+    long long esperado = (long long)total_itens * (total_itens - 1) / 2;
+
+    double inicio = agora();
+    pthread_create(&tc, NULL, consumidor, &soma);
+    pthread_create(&tp, NULL, produtor, NULL);
+    pthread_join(tp, NULL);
+    pthread_join(tc, NULL);
+    double tempo = agora() - inicio;
+
+    double mops = total_itens / tempo / 1e6;
+    printf("%-22s %8.3f s  %8.2f Mitens/s  %6.1f ns/item  %s\n", nome, tempo,
+           mops, tempo * 1e9 / total_itens, soma == esperado ? "ok" : "SOMA INCORRETA");
+    return mops;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_itens = atol(argv[1]);
+    if (argc > 2) capacidade = atoi(argv[2]);
+
+    printf("itens=%ld capacidade=%d\n", total_itens, capacidade);
+
+    circular = initializeBuffer(capacidade);
+    double base = executar("CircularBuffer+mutex", produtorMutex, consumidorMutex);
+    releaseBuffer(circular);
+
+    spsc = initializeSpscBuffer(capacidade);
+    double novo = executar("SpscBuffer", produtorSpsc, consumidorSpsc);
+    releaseSpscBuffer(spsc);
+
+    printf("ganho: %.2fx\n", novo / base);
+    return 0;
+}
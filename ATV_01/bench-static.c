@@ -0,0 +1,132 @@
+/*--------------------------------------------------------------------------
+Benchmark: buffer estático genérico (ring-static.h) contra o
+CircularBuffer com malloc (BufferCircular.h).
+
+Velocidade: mesmo laço de bench-pow2.c (buffer pela metade, uma inserção
+e uma remoção por operação), com capacidade 1024 nos dois casos.
+
+Tamanho de código: as operações de cada versão ficam em funções
+'noinline' separadas (circular* e estatico*). Depois de compilar:
+
+    nm -S --size-sort bench-static | grep -E ' (circular|estatico)'
+
+e, para o Cortex-M0+ (mesmas funções, sem o main de benchmark):
+
+    arm-none-eabi-gcc -mcpu=cortex-m0plus -mthumb -Os -DSO_TAMANHO -c \
+        bench-static.c -o bench-static.o
+    arm-none-eabi-nm -S --size-sort bench-static.o
+
+O CircularBuffer ainda traz malloc/free (e _sbrk) para a imagem, o que
+não aparece no tamanho das funções mas aparece no .map do firmware.
+
+Compilação:  gcc -O2 bench-static.c -o bench-static
+Uso:         ./bench-static [operações]
+----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "BufferCircular.h"
+#include "ring-static.h"
+
+#define CAPACIDADE 1024
+
+RING_DECLARE(IntRing, int, CAPACIDADE)
+
+static IntRing estatico;
+
+__attribute__((noinline)) int circularInsert(CircularBuffer *buf, int item) {
+    return insertItemPow2(buf, item);
+}
+
+__attribute__((noinline)) int circularRemove(CircularBuffer *buf, int *item) {
+    return removeItemPow2(buf, item);
+}
+
+__attribute__((noinline)) int circularModuloInsert(CircularBuffer *buf, int item) {
+    return insertItem(buf, item);
+}
+
+__attribute__((noinline)) int circularModuloRemove(CircularBuffer *buf, int *item) {
+    return removeItem(buf, item);
+}
+
+__attribute__((noinline)) int estaticoInsert(IntRing *r, int item) {
+    return IntRingInsert(r, item);
+}
+
+__attribute__((noinline)) int estaticoRemove(IntRing *r, int *item) {
+    return IntRingRemove(r, item);
+}
+
+#ifndef SO_TAMANHO
+
+#include <time.h>
+
+static long total_ops = 50000000;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void relatar(const char *nome, double tempo, long long soma) {
+    printf("%-24s %8.3f s  %6.2f ns/op  (soma %lld)\n", nome, tempo,
+           tempo * 1e9 / total_ops, soma);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_ops = atol(argv[1]);
+    printf("operações=%ld capacidade=%d\n", total_ops, CAPACIDADE);
+
+    long long soma;
+    int item = 0;
+    double inicio;
+
+    /* CircularBuffer, modo módulo */
+    CircularBuffer *buf = initializeBuffer(CAPACIDADE);
+    for (int i = 0; i < CAPACIDADE / 2; i++) circularModuloInsert(buf, i);
+    soma = 0;
+    inicio = agora();
+    for (long i = 0; i < total_ops; i++) {
+        circularModuloInsert(buf, (int)i);
+        circularModuloRemove(buf, &item);
+        soma += item;
+    }
+    double tModulo = agora() - inicio;
+    relatar("CircularBuffer (modulo)", tModulo, soma);
+    releaseBuffer(buf);
+
+    /* CircularBuffer, modo potência de dois */
+    buf = initializeBufferPow2(CAPACIDADE);
+    for (int i = 0; i < CAPACIDADE / 2; i++) circularInsert(buf, i);
+    soma = 0;
+    inicio = agora();
+    for (long i = 0; i < total_ops; i++) {
+        circularInsert(buf, (int)i);
+        circularRemove(buf, &item);
+        soma += item;
+    }
+    double tPow2 = agora() - inicio;
+    relatar("CircularBuffer (pow2)", tPow2, soma);
+    releaseBuffer(buf);
+
+    /* Buffer estático */
+    for (int i = 0; i < CAPACIDADE / 2; i++) estaticoInsert(&estatico, i);
+    soma = 0;
+    inicio = agora();
+    for (long i = 0; i < total_ops; i++) {
+        estaticoInsert(&estatico, (int)i);
+        estaticoRemove(&estatico, &item);
+        soma += item;
+    }
+    double tEstatico = agora() - inicio;
+    relatar("RING_DECLARE (estatico)", tEstatico, soma);
+
+    printf("ganho sobre modulo: %.2fx, sobre pow2: %.2fx\n",
+           tModulo / tEstatico, tPow2 / tEstatico);
+    return 0;
+}
+
+#endif /* SO_TAMANHO */
@@ -0,0 +1,86 @@
+/*--------------------------------------------------------------------------
+Benchmark: mínimo/máximo/média das últimas N amostras a cada amostra.
+
+  varredura   CircularBuffer no modo sobrescrita + varredura da janela
+              inteira a cada relatório (como é feito hoje), O(N);
+  janela      WINDOW_DECLARE (window-ring.h), O(1) amortizado.
+
+Os dados são um sinal de sensor com ruído (passeio aleatório).
+
+Compilação:  gcc -O2 bench-window.c -o bench-window
+Uso:         ./bench-window [amostras]
+----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BufferCircular.h"
+#include "window-ring.h"
+
+#define JANELA 256
+
+WINDOW_DECLARE(Janela, int, long long, JANELA)
+
+static long total_amostras = 10000000;
+static int *sinal;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void relatar(const char *nome, double tempo, long long verificacao) {
+    printf("%-11s %8.2f ns/amostra  verificação %lld\n", nome, tempo / total_amostras * 1e9, verificacao);
+}
+
+static void medirVarredura(void) {
+    CircularBuffer *buf = initializeBuffer(JANELA);
+    setBufferPolicy(buf, BUFFER_OVERWRITE);
+    long long verificacao = 0;
+    double inicio = agora();
+    for (long i = 0; i < total_amostras; i++) {
+        insertItem(buf, sinal[i]);
+        int min = buf->data[buf->rear], max = min;
+        long long soma = 0;
+        for (int k = 0; k < buf->size; k++) {
+            int v = buf->data[(buf->rear + k) % buf->capacity];
+            min = v < min ? v : min;
+            max = v > max ? v : max;
+            soma += v;
+        }
+        verificacao += min + max + soma / buf->size;
+    }
+    relatar("varredura", agora() - inicio, verificacao);
+    releaseBuffer(buf);
+}
+
+static void medirJanela(void) {
+    static Janela janela;
+    long long verificacao = 0;
+    double inicio = agora();
+    for (long i = 0; i < total_amostras; i++) {
+        JanelaInsert(&janela, sinal[i]);
+        verificacao += JanelaMin(&janela) + JanelaMax(&janela) + JanelaMean(&janela);
+    }
+    relatar("janela", agora() - inicio, verificacao);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_amostras = atol(argv[1]);
+    sinal = malloc(total_amostras * sizeof(int));
+    unsigned semente = 1;
+    int valor = 2000;
+    for (long i = 0; i < total_amostras; i++) {
+        semente = semente * 1103515245u + 12345u;
+        valor += (int)((semente >> 16) % 9) - 4;
+        sinal[i] = valor;
+    }
+
+    printf("amostras=%ld janela=%d\n", total_amostras, JANELA);
+    medirVarredura();
+    medirJanela();
+    free(sinal);
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*--------------------------------------------------------------------------
+Buffer circular bloqueante para o host, com espera em futex (Linux).
+
+Em vez de o consumidor ficar testando o buffer em laço (como a tarefa_8
+do exemplo de RTOS faz com SemaforoCheio.contador), blockingRemoveItem
+estaciona a thread em um futex quando o buffer está vazio, e
+blockingInsertItem faz o mesmo quando está cheio.
+
+Os dados passam por um SpscBuffer (spsc-buffer.h): o CircularBuffer
+comum compartilha 'size' entre os dois lados e não pode ser usado por
+duas threads sem trava. A syscall de despertar só é feita quando o
+outro lado anunciou que vai dormir ('consumerWaiting'/'producerWaiting'),
+então no caso comum inserir e remover não entram no kernel.
+
+Despertar em lote: o consumidor só acorda um produtor bloqueado quando
+houver ao menos 'wakeBatch' posições livres (ou o buffer esvaziar), em
+vez de acordá-lo a cada item removido.
+
+Antes de dormir cada lado tenta 'spinCount' vezes, o que evita a
+syscall quando o outro lado está a poucos ciclos de liberar.
+
+Um produtor e um consumidor. Requer o dialeto GNU padrão do gcc.
+----------------------------------------------------------------------------*/
+
+#ifndef BLOCKING_BUFFER_H
+#define BLOCKING_BUFFER_H
+
+#include <linux/futex.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "BufferCircular.h"
+#include "spsc-buffer.h"
+
+/* Estrutura que representa o buffer bloqueante */
+typedef struct {
+    SpscBuffer *ring;                                       // Dados
+    alignas(SPSC_CACHE_LINE) atomic_uint notEmpty;          // Futex do consumidor
+    atomic_int consumerWaiting;                             // 1 se o consumidor vai dormir
+    alignas(SPSC_CACHE_LINE) atomic_uint notFull;           // Futex do produtor
+    atomic_int producerWaiting;                             // 1 se o produtor vai dormir
+    alignas(SPSC_CACHE_LINE) atomic_int freed;              // Posições liberadas desde o último despertar
+    int wakeBatch;                                          // Ver comentário do arquivo
+    int spinCount;
+    atomic_ulong wakeCalls;                                 // FUTEX_WAKE feitos (estatística)
+    atomic_ulong waitCalls;                                 // FUTEX_WAIT feitos (estatística)
+} BlockingBuffer;
+
+/* Criação de um novo buffer bloqueante */
+static inline BlockingBuffer* initializeBlockingBuffer(int capacidade, int loteDespertar) {
+    size_t tamanho = (sizeof(BlockingBuffer) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    BlockingBuffer *b = (BlockingBuffer *)aligned_alloc(SPSC_CACHE_LINE, tamanho);
+    b->ring = initializeSpscBuffer(capacidade);
+    atomic_init(&b->notEmpty, 0);
+    atomic_init(&b->consumerWaiting, 0);
+    atomic_init(&b->notFull, 0);
+    atomic_init(&b->producerWaiting, 0);
+    atomic_init(&b->freed, 0);
+    atomic_init(&b->wakeCalls, 0);
+    atomic_init(&b->waitCalls, 0);
+    b->wakeBatch = loteDespertar < 1 ? 1 : (loteDespertar > capacidade ? capacidade : loteDespertar);
+    b->spinCount = 100;
+    return b;
+}
+
+/* Liberação da memória do buffer */
+static inline void releaseBlockingBuffer(BlockingBuffer *b) {
+    releaseSpscBuffer(b->ring);
+    free(b);
+}
+
+/* Espera no futex enquanto *endereco == valor, até o prazo (NULL = sem prazo) */
+static inline void blockingFutexWait(BlockingBuffer *b, atomic_uint *endereco, unsigned valor,
+                                     const struct timespec *prazo) {
+    struct timespec restante, *tempo = NULL;
+    if (prazo) {
+        struct timespec agora;
+        clock_gettime(CLOCK_MONOTONIC, &agora);
+        restante.tv_sec = prazo->tv_sec - agora.tv_sec;
+        restante.tv_nsec = prazo->tv_nsec - agora.tv_nsec;
+        if (restante.tv_nsec < 0) {
+            restante.tv_sec--;
+            restante.tv_nsec += 1000000000L;
+        }
+        if (restante.tv_sec < 0) {
+            return;
+        }
+        tempo = &restante;
+    }
+    atomic_fetch_add_explicit(&b->waitCalls, 1, memory_order_relaxed);
+    syscall(SYS_futex, (unsigned *)endereco, FUTEX_WAIT_PRIVATE, valor, tempo, NULL, 0);
+}
+
+/* Acorda quem espera em 'endereco' */
+static inline void blockingFutexWake(BlockingBuffer *b, atomic_uint *endereco) {
+    atomic_fetch_add_explicit(endereco, 1, memory_order_release);
+    atomic_fetch_add_explicit(&b->wakeCalls, 1, memory_order_relaxed);
+    syscall(SYS_futex, (unsigned *)endereco, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/* Converte um tempo limite em ms (< 0 = sem limite) em prazo absoluto */
+static inline const struct timespec *blockingDeadline(struct timespec *prazo, int timeoutMs) {
+    if (timeoutMs < 0) {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, prazo);
+    prazo->tv_sec += timeoutMs / 1000;
+    prazo->tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+    if (prazo->tv_nsec >= 1000000000L) {
+        prazo->tv_sec++;
+        prazo->tv_nsec -= 1000000000L;
+    }
+    return prazo;
+}
+
+/* Prazo já passou? */
+static inline int blockingExpired(const struct timespec *prazo) {
+    if (prazo == NULL) {
+        return 0;
+    }
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return agora.tv_sec > prazo->tv_sec ||
+           (agora.tv_sec == prazo->tv_sec && agora.tv_nsec >= prazo->tv_nsec);
+}
+
+/*
+ * O produtor retira o anúncio de espera (acordou, desistiu pelo prazo ou
+ * inseriu na conferência). O lote recomeça: posições liberadas nesta
+ * espera não contam para a próxima.
+ */
+static inline void blockingProducerWithdraw(BlockingBuffer *b) {
+    atomic_store_explicit(&b->producerWaiting, 0, memory_order_relaxed);
+    atomic_store_explicit(&b->freed, 0, memory_order_relaxed);
+}
+
+/*
+ * Inserção bloqueante (somente o produtor).
+ * Espera até haver espaço ou até 'timeoutMs' ms (< 0 = sem limite; 0 =
+ * não espera). Retorna BUFFER_OK ou BUFFER_FULL se o tempo esgotar.
+ */
+static inline BufferStatus blockingInsertItem(BlockingBuffer *b, int item, int timeoutMs) {
+    struct timespec prazoBuf;
+    const struct timespec *prazo = NULL;
+    int tentativas = 0;
+    while (!spscInsertItem(b->ring, item)) {
+        if (timeoutMs == 0) {
+            return BUFFER_FULL;
+        }
+        if (tentativas++ < b->spinCount) {
+            continue;
+        }
+        if (prazo == NULL && timeoutMs > 0) {
+            prazo = blockingDeadline(&prazoBuf, timeoutMs);
+        }
+        if (blockingExpired(prazo)) {
+            return BUFFER_FULL;
+        }
+        unsigned seq = atomic_load_explicit(&b->notFull, memory_order_acquire);
+        atomic_store_explicit(&b->producerWaiting, 1, memory_order_relaxed);
+        /* Confere de novo depois de anunciar a espera (evita perder o
+           despertar). A barreira faz par com a do consumidor depois da
+           remoção: o store do anúncio e o load de 'rear' não podem ser
+           reordenados, senão os dois lados podem ler o valor antigo */
+        atomic_thread_fence(memory_order_seq_cst);
+        if (spscInsertItem(b->ring, item)) {
+            blockingProducerWithdraw(b);
+            break;
+        }
+        blockingFutexWait(b, &b->notFull, seq, prazo);
+        blockingProducerWithdraw(b);
+    }
+    /* Quem acorda limpa o anúncio: os itens seguintes da rajada não
+       repetem a syscall enquanto o consumidor ainda não voltou a rodar */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&b->consumerWaiting, memory_order_relaxed) &&
+        atomic_exchange_explicit(&b->consumerWaiting, 0, memory_order_relaxed)) {
+        blockingFutexWake(b, &b->notEmpty);
+    }
+    return BUFFER_OK;
+}
+
+/*
+ * Remoção bloqueante (somente o consumidor).
+ * Espera até haver um item ou até 'timeoutMs' ms (< 0 = sem limite; 0 =
+ * não espera). Retorna BUFFER_OK ou BUFFER_EMPTY se o tempo esgotar.
+ */
+static inline BufferStatus blockingRemoveItem(BlockingBuffer *b, int *item, int timeoutMs) {
+    struct timespec prazoBuf;
+    const struct timespec *prazo = NULL;
+    int tentativas = 0;
+    while (!spscRemoveItem(b->ring, item)) {
+        if (timeoutMs == 0) {
+            return BUFFER_EMPTY;
+        }
+        if (tentativas++ < b->spinCount) {
+            continue;
+        }
+        if (prazo == NULL && timeoutMs > 0) {
+            prazo = blockingDeadline(&prazoBuf, timeoutMs);
+        }
+        if (blockingExpired(prazo)) {
+            return BUFFER_EMPTY;
+        }
+        unsigned seq = atomic_load_explicit(&b->notEmpty, memory_order_acquire);
+        atomic_store_explicit(&b->consumerWaiting, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);  // Ver blockingInsertItem
+        if (spscRemoveItem(b->ring, item)) {
+            atomic_store_explicit(&b->consumerWaiting, 0, memory_order_relaxed);
+            break;
+        }
+        blockingFutexWait(b, &b->notEmpty, seq, prazo);
+        atomic_store_explicit(&b->consumerWaiting, 0, memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&b->producerWaiting, memory_order_relaxed)) {
+        int liberadas = atomic_load_explicit(&b->freed, memory_order_relaxed) + 1;
+        if ((liberadas >= b->wakeBatch || isSpscBufferEmpty(b->ring)) &&
+            atomic_exchange_explicit(&b->producerWaiting, 0, memory_order_relaxed)) {
+            atomic_store_explicit(&b->freed, 0, memory_order_relaxed);
+            blockingFutexWake(b, &b->notFull);
+        } else {
+            atomic_store_explicit(&b->freed, liberadas, memory_order_relaxed);
+        }
+    }
+    return BUFFER_OK;
+}
+
+#endif /* BLOCKING_BUFFER_H */
@@ -0,0 +1,188 @@
+/*--------------------------------------------------------------------------
+Buffer circular de difusão: um escritor, vários leitores (estilo
+disruptor).
+
+Há uma única cópia dos dados. Cada leitor registra o seu próprio cursor
+('rear' de um CircularBuffer) e o escritor mantém apenas 'front'. Quando
+um leitor fica para trás, o comportamento depende da política:
+
+  BROADCAST_BLOCK  broadcastInsertItem retorna 0 enquanto o leitor mais
+                   lento estiver 'capacity' itens atrás; o escritor
+                   decide se espera ou tenta de novo.
+  BROADCAST_DROP   o escritor nunca espera e sobrescreve os itens mais
+                   antigos; o leitor atrasado pula para o item mais
+                   antigo ainda válido e soma o que perdeu em 'dropped'.
+
+Para o leitor detectar que o item foi sobrescrito enquanto o lia, o
+escritor publica 'claim' (o índice que está escrevendo) antes de gravar
+o item, no padrão seqlock; os itens são lidos/gravados como atomics
+relaxed, então isso é livre de data race no modelo do C11.
+
+A capacidade é arredondada para potência de dois.
+----------------------------------------------------------------------------*/
+
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#ifndef BROADCAST_CACHE_LINE
+#define BROADCAST_CACHE_LINE 64
+#endif
+
+#ifndef BROADCAST_MAX_READERS
+#define BROADCAST_MAX_READERS 8
+#endif
+
+/* Política para leitores lentos */
+typedef enum {
+    BROADCAST_BLOCK,
+    BROADCAST_DROP
+} BroadcastPolicy;
+
+/* Cursor de um leitor (cada um na sua linha de cache) */
+typedef struct {
+    alignas(BROADCAST_CACHE_LINE) atomic_uint cursor; // Próximo índice a ler
+    atomic_int active;                                // 1 se registrado
+    atomic_ulong dropped;                             // Itens perdidos (BROADCAST_DROP)
+} BroadcastReader;
+
+/* Estrutura que representa o buffer de difusão */
+typedef struct {
+    alignas(BROADCAST_CACHE_LINE) atomic_uint front; // Índice de inserção publicado
+    atomic_uint claim;                               // Índice sendo escrito + 1
+    unsigned minCache;                               // Cursor mais lento visto pelo escritor
+    BroadcastPolicy policy;
+    alignas(BROADCAST_CACHE_LINE) BroadcastReader readers[BROADCAST_MAX_READERS];
+    atomic_int *data;                                // Dados (uma cópia para todos)
+    unsigned mask;                                   // capacity - 1
+    int capacity;                                    // Capacidade (potência de dois)
+} BroadcastRing;
+
+/* Criação de um novo buffer de difusão */
+static inline BroadcastRing* initializeBroadcastRing(int capacidade, BroadcastPolicy politica) {
+    unsigned cap = 2;
+    while (cap < (unsigned)capacidade) {
+        cap <<= 1;
+    }
+    size_t tamanho = (sizeof(BroadcastRing) + BROADCAST_CACHE_LINE - 1) &
+                     ~(size_t)(BROADCAST_CACHE_LINE - 1);
+    BroadcastRing *ring = (BroadcastRing *)aligned_alloc(BROADCAST_CACHE_LINE, tamanho);
+    ring->data = (atomic_int *)malloc(cap * sizeof(atomic_int));
+    ring->mask = cap - 1;
+    ring->capacity = (int)cap;
+    ring->policy = politica;
+    ring->minCache = 0;
+    atomic_init(&ring->front, 0);
+    atomic_init(&ring->claim, 0);
+    for (int i = 0; i < BROADCAST_MAX_READERS; i++) {
+        atomic_init(&ring->readers[i].cursor, 0);
+        atomic_init(&ring->readers[i].active, 0);
+        atomic_init(&ring->readers[i].dropped, 0);
+    }
+    return ring;
+}
+
+/* Liberação da memória do buffer */
+static inline void releaseBroadcastRing(BroadcastRing *ring) {
+    free(ring->data);
+    free(ring);
+}
+
+/*
+ * Registro de um leitor. Ele passa a receber os itens inseridos a partir
+ * de agora. Retorna o identificador do leitor ou -1 se não houver vaga.
+ * Deve ser chamado por uma única thread de controle (não concorre com
+ * outro broadcastAddReader).
+ */
+static inline int broadcastAddReader(BroadcastRing *ring) {
+    for (int i = 0; i < BROADCAST_MAX_READERS; i++) {
+        if (!atomic_load_explicit(&ring->readers[i].active, memory_order_relaxed)) {
+            atomic_store_explicit(&ring->readers[i].cursor,
+                                  atomic_load_explicit(&ring->front, memory_order_acquire),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&ring->readers[i].dropped, 0, memory_order_relaxed);
+            atomic_store_explicit(&ring->readers[i].active, 1, memory_order_release);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Cancelamento do registro de um leitor (o escritor deixa de esperá-lo) */
+static inline void broadcastRemoveReader(BroadcastRing *ring, int leitor) {
+    atomic_store_explicit(&ring->readers[leitor].active, 0, memory_order_release);
+}
+
+/* Itens perdidos por um leitor na política BROADCAST_DROP */
+static inline unsigned long broadcastDropped(BroadcastRing *ring, int leitor) {
+    return atomic_load_explicit(&ring->readers[leitor].dropped, memory_order_relaxed);
+}
+
+/* Cursor do leitor ativo mais lento (ou 'front' se não houver leitores) */
+static inline unsigned broadcastSlowest(BroadcastRing *ring, unsigned front) {
+    unsigned menor = front;
+    for (int i = 0; i < BROADCAST_MAX_READERS; i++) {
+        if (atomic_load_explicit(&ring->readers[i].active, memory_order_acquire)) {
+            unsigned c = atomic_load_explicit(&ring->readers[i].cursor, memory_order_acquire);
+            if (front - c > front - menor) {
+                menor = c;
+            }
+        }
+    }
+    return menor;
+}
+
+/*
+ * Inserção de um item (somente o escritor).
+ * Retorna 0 se a política for BROADCAST_BLOCK e o leitor mais lento
+ * ainda não liberou a posição.
+ */
+static inline int broadcastInsertItem(BroadcastRing *ring, int item) {
+    unsigned front = atomic_load_explicit(&ring->front, memory_order_relaxed);
+    if (ring->policy == BROADCAST_BLOCK && front - ring->minCache >= (unsigned)ring->capacity) {
+        ring->minCache = broadcastSlowest(ring, front);
+        if (front - ring->minCache >= (unsigned)ring->capacity) {
+            return 0;
+        }
+    }
+    atomic_store_explicit(&ring->claim, front + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&ring->data[front & ring->mask], item, memory_order_relaxed);
+    atomic_store_explicit(&ring->front, front + 1, memory_order_release);
+    return 1;
+}
+
+/*
+ * Remoção de um item por um leitor (cada leitor em uma única thread).
+ * Retorna 0 se não houver item novo para esse leitor.
+ */
+static inline int broadcastRemoveItem(BroadcastRing *ring, int leitor, int *item) {
+    BroadcastReader *r = &ring->readers[leitor];
+    unsigned cursor = atomic_load_explicit(&r->cursor, memory_order_relaxed);
+    for (;;) {
+        unsigned front = atomic_load_explicit(&ring->front, memory_order_acquire);
+        if (cursor == front) {
+            return 0;
+        }
+        if (front - cursor > (unsigned)ring->capacity) {
+            /* Leitor foi ultrapassado: pula para o item mais antigo válido */
+            unsigned perdidos = front - cursor - ring->capacity;
+            atomic_fetch_add_explicit(&r->dropped, perdidos, memory_order_relaxed);
+            cursor += perdidos;
+        }
+        int valor = atomic_load_explicit(&ring->data[cursor & ring->mask], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        unsigned claim = atomic_load_explicit(&ring->claim, memory_order_relaxed);
+        if (claim - cursor <= (unsigned)ring->capacity) {
+            *item = valor;
+            atomic_store_explicit(&r->cursor, cursor + 1, memory_order_release);
+            return 1;
+        }
+        /* O item foi sobrescrito durante a leitura: tenta novamente */
+    }
+}
+
+#endif /* BROADCAST_RING_H */
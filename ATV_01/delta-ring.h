@@ -0,0 +1,215 @@
+/*--------------------------------------------------------------------------
+Buffer circular compactado para telemetria: delta + zigzag + varint.
+
+Amostras de sensor costumam mudar poucas unidades entre leituras, mas o
+CircularBuffer guarda cada uma em um int de 4 bytes. O DeltaRing guarda
+a diferença para a amostra anterior em zigzag (-1 -> 1, 1 -> 2, ...)
+codificada em varint, então deltas de -32 a 31 ocupam 1 byte.
+
+Formato de cada registro (bytes com o bit 7 = "continua"):
+    1º byte:  bit 0 = 1 se for quadro-chave, bits 1..6 = 6 bits baixos
+    demais:   7 bits cada, do menos para o mais significativo
+Um quadro-chave guarda o valor absoluto (zigzag) em vez do delta e é
+gravado a cada 'keyInterval' amostras. Como todo registro termina em um
+byte com o bit 7 zerado, um leitor que perdeu o estado (ou começa a ler
+um despejo da memória no meio) acha o início do registro seguinte e
+avança até o próximo quadro-chave: ver deltaSeekKeyframe.
+
+Até 5 bytes por registro, só com operações de 32 bits (sem divisão nem
+aritmética de 64 bits no Cortex-M0+). A memória é fornecida por quem
+chama e o tamanho é arredondado para baixo até potência de dois.
+Um único contexto (como o CircularBuffer).
+----------------------------------------------------------------------------*/
+
+#ifndef DELTA_RING_H
+#define DELTA_RING_H
+
+#include <stdint.h>
+
+#include "BufferCircular.h"
+
+#define DELTA_MAX_RECORD 5
+
+/* Estrutura que representa o buffer compactado */
+typedef struct {
+    uint8_t *data;          // Área de armazenamento (fornecida por quem chama)
+    unsigned mask;          // Tamanho de 'data' - 1
+    unsigned front;         // Posição livre de escrita (bytes)
+    unsigned rear;          // Posição livre de leitura (bytes)
+    unsigned count;         // Amostras no buffer
+    unsigned keyInterval;   // Amostras entre quadros-chave
+    unsigned sinceKey;      // Amostras gravadas desde o último quadro-chave
+    int32_t lastIn;         // Última amostra gravada (codificador)
+    int32_t lastOut;        // Última amostra lida (decodificador)
+    BufferPolicy policy;    // Comportamento com o buffer cheio
+    unsigned drops;         // Amostras rejeitadas (BUFFER_REJECT)
+    unsigned overwrites;    // Amostras antigas descartadas (BUFFER_OVERWRITE)
+} DeltaRing;
+
+/* Inicialização sobre uma área de memória estática ou da pilha */
+static inline void initializeDeltaRing(DeltaRing *ring, uint8_t *memoria, unsigned tamanho,
+                                       unsigned intervaloChave) {
+    unsigned cap = 1;
+    while (cap * 2 <= tamanho) {
+        cap <<= 1;
+    }
+    ring->data = memoria;
+    ring->mask = cap - 1;
+    ring->front = 0;
+    ring->rear = 0;
+    ring->count = 0;
+    ring->keyInterval = intervaloChave ? intervaloChave : 1;
+    ring->sinceKey = 0;
+    ring->lastIn = 0;
+    ring->lastOut = 0;
+    ring->policy = BUFFER_REJECT;
+    ring->drops = 0;
+    ring->overwrites = 0;
+}
+
+/* Bytes ocupados */
+static inline unsigned deltaBytesUsed(const DeltaRing *ring) {
+    return ring->front - ring->rear;
+}
+
+/* Número de amostras no buffer */
+static inline unsigned deltaCount(const DeltaRing *ring) {
+    return ring->count;
+}
+
+/* Checa se o buffer está vazio */
+static inline int isDeltaRingEmpty(const DeltaRing *ring) {
+    return ring->count == 0;
+}
+
+/* Codifica um registro em 'saida'; retorna o número de bytes */
+static inline unsigned deltaEncode(uint8_t *saida, uint32_t zigzag, int chave) {
+    unsigned n = 0;
+    uint8_t byte = (uint8_t)(((zigzag & 0x3F) << 1) | (chave ? 1 : 0));
+    zigzag >>= 6;
+    while (zigzag) {
+        saida[n++] = byte | 0x80;
+        byte = (uint8_t)(zigzag & 0x7F);
+        zigzag >>= 7;
+    }
+    saida[n++] = byte;
+    return n;
+}
+
+/* Decodifica o registro na posição 'pos' sem consumir; retorna o número de bytes */
+static inline unsigned deltaDecode(const DeltaRing *ring, unsigned pos, uint32_t *zigzag, int *chave) {
+    uint8_t byte = ring->data[pos & ring->mask];
+    unsigned n = 1, desloc = 6;
+    *chave = byte & 1;
+    uint32_t valor = (byte >> 1) & 0x3F;
+    while (byte & 0x80) {
+        byte = ring->data[(pos + n++) & ring->mask];
+        valor |= (uint32_t)(byte & 0x7F) << desloc;
+        desloc += 7;
+    }
+    *zigzag = valor;
+    return n;
+}
+
+/* Aplica o registro decodificado ao estado do leitor */
+static inline int32_t deltaApply(DeltaRing *ring, uint32_t zigzag, int chave) {
+    int32_t valor = (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+    if (!chave) {
+        valor = (int32_t)((uint32_t)ring->lastOut + (uint32_t)valor);
+    }
+    ring->lastOut = valor;
+    return valor;
+}
+
+/* Remoção de uma amostra. Retorna 0 se o buffer estiver vazio. */
+static inline int deltaRemoveItem(DeltaRing *ring, int32_t *item) {
+    if (ring->count == 0) {
+        return 0;
+    }
+    uint32_t zigzag;
+    int chave;
+    ring->rear += deltaDecode(ring, ring->rear, &zigzag, &chave);
+    ring->count--;
+    *item = deltaApply(ring, zigzag, chave);
+    return 1;
+}
+
+/*
+ * Inserção de uma amostra.
+ *
+ * Sem espaço retorna BUFFER_FULL (BUFFER_REJECT) ou descarta as amostras
+ * mais antigas até caber e retorna BUFFER_OVERWRITTEN (BUFFER_OVERWRITE).
+ */
+static inline BufferStatus deltaInsertItem(DeltaRing *ring, int32_t item) {
+    uint8_t registro[DELTA_MAX_RECORD];
+    int chave = ring->sinceKey == 0 || ring->count == 0;
+    int32_t valor = chave ? item : (int32_t)((uint32_t)item - (uint32_t)ring->lastIn);
+    uint32_t zigzag = ((uint32_t)valor << 1) ^ (uint32_t)(valor >> 31);
+    unsigned n = deltaEncode(registro, zigzag, chave);
+
+    BufferStatus status = BUFFER_OK;
+    while (ring->mask + 1 - deltaBytesUsed(ring) < n) {
+        if (ring->policy == BUFFER_REJECT || ring->count == 0) {
+            ring->drops++;
+            return BUFFER_FULL;
+        }
+        int32_t descartado;
+        deltaRemoveItem(ring, &descartado);
+        ring->overwrites++;
+        status = BUFFER_OVERWRITTEN;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        ring->data[(ring->front + i) & ring->mask] = registro[i];
+    }
+    ring->front += n;
+    ring->count++;
+    ring->lastIn = item;
+    ring->sinceKey = chave ? 1 : ring->sinceKey + 1;
+    if (ring->sinceKey == ring->keyInterval) {
+        ring->sinceKey = 0;
+    }
+    return status;
+}
+
+/*
+ * Ressincronização do leitor: descarta os bytes até o início do próximo
+ * quadro-chave, que passa a ser o próximo registro lido.
+ *
+ * Usada quando o estado do leitor não é confiável (ex.: 'rear' ajustado a
+ * partir de uma posição qualquer). Primeiro acha o fim do registro em
+ * curso (um byte com o bit 7 zerado), depois pula registros até um com
+ * o bit de quadro-chave. Retorna quantas amostras foram descartadas; se
+ * não houver quadro-chave pendente o buffer fica vazio.
+ */
+static inline unsigned deltaSeekKeyframe(DeltaRing *ring, int meioDeRegistro) {
+    unsigned descartadas = 0;
+    if (meioDeRegistro) {
+        while (ring->rear != ring->front && (ring->data[ring->rear & ring->mask] & 0x80)) {
+            ring->rear++;
+        }
+        if (ring->rear != ring->front) {
+            ring->rear++;
+        }
+    }
+    while (ring->rear != ring->front) {
+        uint32_t zigzag;
+        int chave;
+        unsigned n = deltaDecode(ring, ring->rear, &zigzag, &chave);
+        if (chave) {
+            break;
+        }
+        ring->rear += n;
+        descartadas++;
+    }
+    /* Recontagem: o número de registros restantes não é conhecido */
+    unsigned restantes = 0;
+    for (unsigned pos = ring->rear; pos != ring->front; restantes++) {
+        uint32_t zigzag;
+        int chave;
+        pos += deltaDecode(ring, pos, &zigzag, &chave);
+    }
+    ring->count = restantes;
+    return descartadas;
+}
+
+#endif /* DELTA_RING_H */
@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------------
+Buffer circular espelhado na memória virtual (somente Linux).
+
+As mesmas páginas físicas (um memfd) são mapeadas duas vezes, uma logo
+após a outra. Assim data[i] e data[i + capacity] são o mesmo inteiro, e
+qualquer janela de até 'capacity' itens a partir de qualquer posição é
+contígua: quem consome pode usar memchr/memcmp/laços vetorizados sem
+tratar a volta do buffer.
+
+O resultado é um CircularBuffer comum (modo módulo): insertItem,
+removeItem, insertItems/removeItems e as funções de trecho continuam
+iguais, e peekSpan/reserveSpan passam a devolver todo o conteúdo/espaço
+livre de uma vez. A capacidade é arredondada para que o tamanho em bytes
+seja uma potência de dois múltipla do tamanho de página.
+
+Usa memfd_create/ftruncate/MAP_ANONYMOUS, então precisa do dialeto GNU
+padrão do gcc (não compila com -std=c11 estrito).
+----------------------------------------------------------------------------*/
+
+#ifndef MIRROR_BUFFER_H
+#define MIRROR_BUFFER_H
+
+#include <linux/memfd.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "BufferCircular.h"
+
+/* Desfaz os dois mapeamentos de 'data' */
+static inline void releaseMirroredData(CircularBuffer *buf) {
+    munmap(buf->data, 2 * (size_t)buf->capacity * sizeof(int));
+}
+
+/*
+ * Criação de um buffer espelhado.
+ * Retorna NULL se o kernel não permitir o mapeamento.
+ */
+static inline CircularBuffer* initializeBufferMirrored(int capacidade) {
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bytes = pagina;
+    while (bytes < (size_t)capacidade * sizeof(int)) {
+        bytes <<= 1;
+    }
+
+    int fd = (int)syscall(SYS_memfd_create, "CircularBuffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    /* Reserva 2x o espaço e mapeia o mesmo memfd nas duas metades */
+    uint8_t *base = (uint8_t *)mmap(NULL, 2 * bytes, PROT_NONE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, 2 * bytes);
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+
+    CircularBuffer *buf = initializeBuffer(0);
+    free(buf->data);
+    buf->data = (int *)base;
+    buf->capacity = (int)(bytes / sizeof(int));
+    buf->mirrored = 1;
+    buf->releaseData = releaseMirroredData;
+    return buf;
+}
+
+#endif /* MIRROR_BUFFER_H */
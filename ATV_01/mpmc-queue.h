@@ -0,0 +1,122 @@
+/*--------------------------------------------------------------------------
+Fila limitada para vários produtores e vários consumidores (MPMC), no
+estilo de Dmitry Vyukov.
+
+Mantém o layout do CircularBuffer (data, front, rear, capacity), mas cada
+posição de 'data' carrega um número de sequência:
+
+  - sequence == pos           a posição está livre para o produtor 'pos';
+  - sequence == pos + 1       a posição contém o item 'pos', pronto para
+                              o consumidor;
+  - após a remoção ela passa a pos + capacity (livre na próxima volta).
+
+Produtores disputam apenas 'front' e consumidores apenas 'rear' (um CAS
+por operação); não há trava global nem contador 'size'. Os dois índices
+ficam em linhas de cache separadas.
+
+Usa compare-and-swap, então é destinada ao host: o Cortex-M0+ (ARMv6-M)
+não tem LDREX/STREX. A capacidade é arredondada para potência de dois.
+----------------------------------------------------------------------------*/
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef MPMC_CACHE_LINE
+#define MPMC_CACHE_LINE 64
+#endif
+
+/* Posição da fila: número de sequência + item */
+typedef struct {
+    atomic_size_t sequence;
+    int item;
+} MpmcSlot;
+
+/* Estrutura que representa a fila MPMC */
+typedef struct {
+    alignas(MPMC_CACHE_LINE) atomic_size_t front; // Próxima posição de inserção
+    alignas(MPMC_CACHE_LINE) atomic_size_t rear;  // Próxima posição de remoção
+    alignas(MPMC_CACHE_LINE) MpmcSlot *data;      // Posições da fila
+    size_t mask;                                  // capacity - 1
+    int capacity;                                 // Capacidade (potência de dois)
+} MpmcQueue;
+
+/* Criação de uma nova fila MPMC */
+static inline MpmcQueue* initializeMpmcQueue(int capacidade) {
+    size_t cap = 2;
+    while (cap < (size_t)capacidade) {
+        cap <<= 1;
+    }
+    size_t tamanho = (sizeof(MpmcQueue) + MPMC_CACHE_LINE - 1) & ~(size_t)(MPMC_CACHE_LINE - 1);
+    MpmcQueue *q = (MpmcQueue *)aligned_alloc(MPMC_CACHE_LINE, tamanho);
+    q->data = (MpmcSlot *)malloc(cap * sizeof(MpmcSlot));
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(&q->data[i].sequence, i);
+    }
+    q->mask = cap - 1;
+    q->capacity = (int)cap;
+    atomic_init(&q->front, 0);
+    atomic_init(&q->rear, 0);
+    return q;
+}
+
+/* Liberação da memória da fila */
+static inline void releaseMpmcQueue(MpmcQueue *q) {
+    free(q->data);
+    free(q);
+}
+
+/* Inserção de um item (qualquer thread). Retorna 0 se a fila estiver cheia. */
+static inline int mpmcInsertItem(MpmcQueue *q, int item) {
+    size_t pos = atomic_load_explicit(&q->front, memory_order_relaxed);
+    for (;;) {
+        MpmcSlot *slot = &q->data[pos & q->mask];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->front, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->item = item;
+                atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+                return 1;
+            }
+            /* CAS falhou: 'pos' já foi atualizado com o valor corrente */
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&q->front, memory_order_relaxed);
+        }
+    }
+}
+
+/* Remoção de um item (qualquer thread). Retorna 0 se a fila estiver vazia. */
+static inline int mpmcRemoveItem(MpmcQueue *q, int *item) {
+    size_t pos = atomic_load_explicit(&q->rear, memory_order_relaxed);
+    for (;;) {
+        MpmcSlot *slot = &q->data[pos & q->mask];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->rear, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                *item = slot->item;
+                atomic_store_explicit(&slot->sequence, pos + q->mask + 1,
+                                      memory_order_release);
+                return 1;
+            }
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&q->rear, memory_order_relaxed);
+        }
+    }
+}
+
+#endif /* MPMC_QUEUE_H */
@@ -0,0 +1,230 @@
+/*--------------------------------------------------------------------------
+Buffer circular persistente em arquivo (mmap), compartilhado entre
+processos e preservado entre reinícios (Linux/POSIX).
+
+O arquivo contém um cabeçalho (identificação, versão, capacidade e os
+índices 'front'/'rear' do CircularBuffer) seguido de 'data'. Um processo
+produtor (ex.: logger) e um consumidor (ex.: uploader) abrem o mesmo
+arquivo e trocam itens sem cópia pelo kernel; os dados não lidos
+continuam no arquivo se algum deles cair ou a máquina reiniciar
+(persistentSync força a gravação no disco).
+
+Os índices correm livres (capacidade potência de dois) e são publicados
+com atomics acquire/release: o produtor grava os itens e só depois
+avança 'front', então um crash no meio de uma inserção apenas perde
+aquele item. Ao abrir, o cabeçalho é conferido; se estiver inconsistente
+os índices são zerados e openPersistentRing retorna PERSISTENT_RESET.
+
+Um produtor e um consumidor (podem estar em processos diferentes).
+Requer o dialeto GNU padrão do gcc.
+----------------------------------------------------------------------------*/
+
+#ifndef PERSISTENT_RING_H
+#define PERSISTENT_RING_H
+
+#include <fcntl.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PERSISTENT_MAGIC   0x52494E47u  // "RING"
+#define PERSISTENT_VERSION 1u
+
+/* Resultado da abertura */
+typedef enum {
+    PERSISTENT_OPENED = 0,  // Arquivo existente, dados pendentes preservados
+    PERSISTENT_CREATED,     // Arquivo novo
+    PERSISTENT_RESET,       // Cabeçalho inconsistente: índices zerados
+    PERSISTENT_ERROR        // Falha de E/S ou capacidade incompatível
+} PersistentStatus;
+
+/* Cabeçalho gravado no início do arquivo */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;                  // Capacidade em itens (potência de dois)
+    uint32_t headerSize;                // Deslocamento de 'data' no arquivo
+    alignas(64) atomic_uint front;      // Índice livre de inserção (produtor)
+    alignas(64) atomic_uint rear;       // Índice livre de remoção (consumidor)
+} PersistentHeader;
+
+/* Visão de um processo sobre o buffer persistente */
+typedef struct {
+    PersistentHeader *header;  // Cabeçalho mapeado
+    int *data;                 // Dados mapeados
+    unsigned mask;             // capacity - 1
+    int capacity;
+    size_t mapSize;            // Tamanho do mapeamento
+} PersistentRing;
+
+/* Cabeçalho válido para a capacidade e o tamanho de arquivo dados */
+static inline int persistentHeaderOk(PersistentHeader *h, uint32_t capacidade, size_t tamanho) {
+    if (h->magic != PERSISTENT_MAGIC || h->version != PERSISTENT_VERSION ||
+        h->capacity != capacidade || h->headerSize != sizeof(PersistentHeader) ||
+        tamanho != sizeof(PersistentHeader) + (size_t)capacidade * sizeof(int)) {
+        return 0;
+    }
+    unsigned front = atomic_load_explicit(&h->front, memory_order_acquire);
+    unsigned rear = atomic_load_explicit(&h->rear, memory_order_acquire);
+    return front - rear <= capacidade;
+}
+
+/* Mapeia e confere (ou inicia) o cabeçalho; chamada com o arquivo travado */
+static inline PersistentStatus persistentOpenLocked(PersistentRing *ring, int fd, uint32_t cap) {
+    size_t tamanho = sizeof(PersistentHeader) + (size_t)cap * sizeof(int);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return PERSISTENT_ERROR;
+    }
+    int novo = st.st_size == 0;
+    if (!novo && (size_t)st.st_size != tamanho) {
+        return PERSISTENT_ERROR;
+    }
+    if (novo && ftruncate(fd, (off_t)tamanho) != 0) {
+        return PERSISTENT_ERROR;
+    }
+    void *mapa = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapa == MAP_FAILED) {
+        return PERSISTENT_ERROR;
+    }
+
+    ring->header = (PersistentHeader *)mapa;
+    ring->data = (int *)((uint8_t *)mapa + sizeof(PersistentHeader));
+    ring->mask = cap - 1;
+    ring->capacity = (int)cap;
+    ring->mapSize = tamanho;
+
+    if (!novo && persistentHeaderOk(ring->header, cap, tamanho)) {
+        return PERSISTENT_OPENED;
+    }
+    PersistentHeader *h = ring->header;
+    h->capacity = cap;
+    h->headerSize = sizeof(PersistentHeader);
+    h->version = PERSISTENT_VERSION;
+    atomic_store_explicit(&h->front, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->rear, 0, memory_order_relaxed);
+    /* 'magic' por último: um cabeçalho pela metade não passa na conferência */
+    atomic_thread_fence(memory_order_release);
+    h->magic = PERSISTENT_MAGIC;
+    return novo ? PERSISTENT_CREATED : PERSISTENT_RESET;
+}
+
+/*
+ * Abertura (ou criação) do buffer no arquivo 'caminho'.
+ * A capacidade (1 a 2^30) é arredondada para potência de dois; um arquivo
+ * existente com outra capacidade retorna PERSISTENT_ERROR.
+ *
+ * Produtor e consumidor costumam abrir o arquivo ao mesmo tempo: o
+ * arquivo fica travado com flock da conferência à iniciação do cabeçalho,
+ * para que um processo não veja o cabeçalho pela metade do outro e zere
+ * índices já em uso.
+ */
+static inline PersistentStatus openPersistentRing(PersistentRing *ring, const char *caminho, int capacidade) {
+    if (capacidade <= 0 || capacidade > (1 << 30)) {
+        return PERSISTENT_ERROR;
+    }
+    uint32_t cap = 2;
+    while (cap < (uint32_t)capacidade) {
+        cap <<= 1;
+    }
+
+    int fd = open(caminho, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return PERSISTENT_ERROR;
+    }
+    if (flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        return PERSISTENT_ERROR;
+    }
+    PersistentStatus status = persistentOpenLocked(ring, fd, cap);
+    flock(fd, LOCK_UN);
+    close(fd);
+    return status;
+}
+
+/* Fechamento (os dados continuam no arquivo) */
+static inline void closePersistentRing(PersistentRing *ring) {
+    munmap(ring->header, ring->mapSize);
+    ring->header = NULL;
+    ring->data = NULL;
+}
+
+/* Força a gravação do arquivo no disco (sobrevive a queda de energia) */
+static inline int persistentSync(PersistentRing *ring) {
+    return msync(ring->header, ring->mapSize, MS_SYNC);
+}
+
+/* Número de itens pendentes */
+static inline int persistentCount(PersistentRing *ring) {
+    return (int)(atomic_load_explicit(&ring->header->front, memory_order_acquire) -
+                 atomic_load_explicit(&ring->header->rear, memory_order_acquire));
+}
+
+/*
+ * Inserção de um bloco de até n itens (somente o produtor).
+ * Retorna quantos itens foram inseridos.
+ */
+static inline int persistentInsertItems(PersistentRing *ring, const int *src, int n) {
+    PersistentHeader *h = ring->header;
+    unsigned front = atomic_load_explicit(&h->front, memory_order_relaxed);
+    unsigned rear = atomic_load_explicit(&h->rear, memory_order_acquire);
+    int livre = ring->capacity - (int)(front - rear);
+    if (n > livre) {
+        n = livre;
+    }
+    if (n <= 0) {
+        return 0;
+    }
+    int pos = (int)(front & ring->mask);
+    int primeiro = ring->capacity - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    memcpy(&ring->data[pos], src, primeiro * sizeof(int));
+    memcpy(&ring->data[0], src + primeiro, (n - primeiro) * sizeof(int));
+    atomic_store_explicit(&h->front, front + n, memory_order_release);
+    return n;
+}
+
+/*
+ * Remoção de um bloco de até n itens (somente o consumidor).
+ * Retorna quantos itens foram removidos.
+ */
+static inline int persistentRemoveItems(PersistentRing *ring, int *dst, int n) {
+    PersistentHeader *h = ring->header;
+    unsigned rear = atomic_load_explicit(&h->rear, memory_order_relaxed);
+    unsigned front = atomic_load_explicit(&h->front, memory_order_acquire);
+    int ocupado = (int)(front - rear);
+    if (n > ocupado) {
+        n = ocupado;
+    }
+    if (n <= 0) {
+        return 0;
+    }
+    int pos = (int)(rear & ring->mask);
+    int primeiro = ring->capacity - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    memcpy(dst, &ring->data[pos], primeiro * sizeof(int));
+    memcpy(dst + primeiro, &ring->data[0], (n - primeiro) * sizeof(int));
+    atomic_store_explicit(&h->rear, rear + n, memory_order_release);
+    return n;
+}
+
+/* Inserção de um item (somente o produtor). Retorna 0 se estiver cheio. */
+static inline int persistentInsertItem(PersistentRing *ring, int item) {
+    return persistentInsertItems(ring, &item, 1);
+}
+
+/* Remoção de um item (somente o consumidor). Retorna 0 se estiver vazio. */
+static inline int persistentRemoveItem(PersistentRing *ring, int *item) {
+    return persistentRemoveItems(ring, item, 1);
+}
+
+#endif /* PERSISTENT_RING_H */
@@ -0,0 +1,145 @@
+/*--------------------------------------------------------------------------
+Buffer circular de registros de tamanho variável (quadros de 0 a 255
+bytes, como os das máquinas de estados da ATV_02/ATV_03).
+
+Cada registro ocupa 1 byte de tamanho seguido do payload, sempre
+contíguo na memória. Quando o registro não cabe antes do fim de 'data',
+o escritor recomeça do início e grava em 'watermark' onde os dados
+válidos terminam (técnica do "bip buffer"); o leitor volta para o
+início ao alcançar essa marca. Assim não é preciso um byte de marcador
+de salto, e o custo por quadro é só o byte de tamanho mais o final de
+'data' desperdiçado numa volta.
+
+As três operações são sem cópia:
+
+    uint8_t *p = recordReserve(&ring, tamanho);  // escritor
+    ... grava até 'tamanho' bytes em p ...
+    recordCommit(&ring, usados);
+
+    const uint8_t *q = recordPeek(&ring, &tamanho);  // leitor
+    ... usa q[0..tamanho-1] ...
+    recordPop(&ring);
+
+Um escritor e um leitor podem rodar em contextos diferentes (ISR e
+tarefa, ou duas threads): 'front' e 'watermark' pertencem ao escritor,
+'rear' ao leitor, e a publicação usa acquire/release como no
+spsc-buffer.h. A memória é fornecida por quem chama (sem malloc).
+----------------------------------------------------------------------------*/
+
+#ifndef RECORD_RING_H
+#define RECORD_RING_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#define RECORD_MAX_LEN 255
+
+/* Estrutura que representa o buffer de registros */
+typedef struct {
+    uint8_t *data;          // Área de armazenamento (fornecida por quem chama)
+    unsigned capacity;      // Tamanho de 'data' em bytes
+    atomic_uint front;      // Posição de escrita (escritor)
+    atomic_uint rear;       // Posição de leitura (leitor)
+    atomic_uint watermark;  // Fim dos dados válidos antes da última volta
+    unsigned reservePos;    // Posição reservada por recordReserve (escritor)
+    int reserveWrap;        // 1 se a reserva recomeçou do início
+} RecordRing;
+
+/* Inicialização sobre uma área de memória estática ou da pilha */
+static inline void initializeRecordRing(RecordRing *ring, uint8_t *memoria, unsigned tamanho) {
+    ring->data = memoria;
+    ring->capacity = tamanho;
+    atomic_init(&ring->front, 0);
+    atomic_init(&ring->rear, 0);
+    atomic_init(&ring->watermark, tamanho);
+    ring->reservePos = 0;
+    ring->reserveWrap = 0;
+}
+
+/*
+ * Reserva espaço contíguo para um registro de até 'tamanho' bytes.
+ * Retorna o ponteiro para o payload ou NULL se não houver espaço.
+ */
+static inline uint8_t *recordReserve(RecordRing *ring, unsigned tamanho) {
+    if (tamanho > RECORD_MAX_LEN) {
+        return NULL;
+    }
+    unsigned total = 1 + tamanho;
+    unsigned f = atomic_load_explicit(&ring->front, memory_order_relaxed);
+    unsigned r = atomic_load_explicit(&ring->rear, memory_order_acquire);
+    if (f >= r) {
+        if (ring->capacity - f >= total) {
+            ring->reservePos = f;
+            ring->reserveWrap = 0;
+        } else if (r > total) {
+            ring->reservePos = 0;
+            ring->reserveWrap = 1;
+        } else {
+            return NULL;
+        }
+    } else if (r - f > total) {
+        ring->reservePos = f;
+        ring->reserveWrap = 0;
+    } else {
+        return NULL;
+    }
+    return &ring->data[ring->reservePos + 1];
+}
+
+/* Publica o registro reservado com 'tamanho' bytes (<= o reservado) */
+static inline void recordCommit(RecordRing *ring, unsigned tamanho) {
+    unsigned pos = ring->reservePos;
+    ring->data[pos] = (uint8_t)tamanho;
+    if (ring->reserveWrap) {
+        atomic_store_explicit(&ring->watermark,
+                              atomic_load_explicit(&ring->front, memory_order_relaxed),
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring->front, pos + 1 + tamanho, memory_order_release);
+}
+
+/* Cópia de um registro para o buffer. Retorna 0 se não houver espaço. */
+static inline int recordPush(RecordRing *ring, const uint8_t *src, unsigned tamanho) {
+    uint8_t *p = recordReserve(ring, tamanho);
+    if (p == NULL) {
+        return 0;
+    }
+    memcpy(p, src, tamanho);
+    recordCommit(ring, tamanho);
+    return 1;
+}
+
+/*
+ * Acesso ao registro mais antigo sem removê-lo.
+ * Retorna o ponteiro para o payload e grava o tamanho em '*tamanho', ou
+ * NULL se o buffer estiver vazio.
+ */
+static inline const uint8_t *recordPeek(RecordRing *ring, unsigned *tamanho) {
+    unsigned r = atomic_load_explicit(&ring->rear, memory_order_relaxed);
+    unsigned f = atomic_load_explicit(&ring->front, memory_order_acquire);
+    if (r == f) {
+        return NULL;
+    }
+    if (f < r && r == atomic_load_explicit(&ring->watermark, memory_order_relaxed)) {
+        /* O escritor recomeçou do início: o restante de 'data' é sobra */
+        r = 0;
+        atomic_store_explicit(&ring->rear, 0, memory_order_release);
+    }
+    *tamanho = ring->data[r];
+    return &ring->data[r + 1];
+}
+
+/* Remoção do registro devolvido pelo último recordPeek */
+static inline void recordPop(RecordRing *ring) {
+    unsigned r = atomic_load_explicit(&ring->rear, memory_order_relaxed);
+    atomic_store_explicit(&ring->rear, r + 1 + ring->data[r], memory_order_release);
+}
+
+/* Checa se não há registros */
+static inline int isRecordRingEmpty(RecordRing *ring) {
+    return atomic_load_explicit(&ring->front, memory_order_acquire) ==
+           atomic_load_explicit(&ring->rear, memory_order_acquire);
+}
+
+#endif /* RECORD_RING_H */
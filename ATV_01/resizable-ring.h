@@ -0,0 +1,220 @@
+/*--------------------------------------------------------------------------
+Buffer circular redimensionável (host).
+
+initializeBuffer fixa a capacidade para sempre: ou se reserva memória
+para o pior caso, ou se perdem dados nas rajadas. O ResizableRing começa
+com 'minCapacity' posições e, quando enche, o produtor migra os itens
+pendentes para um bloco com o dobro do tamanho (até 'maxCapacity'). Os
+itens são copiados em ordem para o início do bloco novo, então o
+conteúdo que dava a volta no bloco antigo fica linear no novo. Quando a
+ocupação cai abaixo de 1/4, o bloco é trocado por um com a metade do
+tamanho (nunca abaixo de 'minCapacity').
+
+Um produtor e um consumidor, sem trava. Os índices correm livres como no
+modo potência de dois; cada bloco guarda o índice 'base' do item que foi
+para data[0]. Passagem de bloco:
+  - o produtor copia, publica o bloco novo (release) e só então grava
+    nele; o bloco antigo não é mais escrito;
+  - o consumidor lê 'front' e depois o bloco atual (acquire). Ao trocar
+    de bloco ele mesmo libera os blocos antigos, que ninguém mais usa.
+O consumidor nunca espera: durante a cópia ele continua lendo o bloco
+antigo, cujos itens também estão no novo. Em compensação, enquanto ele
+não lê, os blocos antigos continuam alocados: no pior caso a memória
+chega a perto de 2 x maxCapacity.
+----------------------------------------------------------------------------*/
+
+#ifndef RESIZABLE_RING_H
+#define RESIZABLE_RING_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BufferCircular.h"
+
+/* Bloco de armazenamento */
+typedef struct ResizableBlock ResizableBlock;
+struct ResizableBlock {
+    ResizableBlock *older;  // Blocos substituídos (liberados pelo consumidor)
+    unsigned base;          // Índice do item em data[0]
+    unsigned mask;          // Capacidade - 1
+    int data[];
+};
+
+/* Estrutura que representa o buffer redimensionável */
+typedef struct {
+    alignas(64) atomic_uint front;          // Índice de inserção (produtor)
+    ResizableBlock *producerBlock;          // Bloco atual visto pelo produtor
+    alignas(64) atomic_uint rear;           // Índice de remoção (consumidor)
+    ResizableBlock *consumerBlock;          // Bloco em uso pelo consumidor
+    alignas(64) _Atomic(ResizableBlock *) block; // Bloco publicado
+    int minCapacity;
+    int maxCapacity;
+    atomic_uint grows;                      // Crescimentos (estatística)
+    atomic_uint shrinks;                    // Reduções (estatística)
+    atomic_uint drops;                      // Itens rejeitados em maxCapacity
+    atomic_size_t bytes;                    // Memória de blocos alocada agora
+    atomic_size_t peakBytes;                // Maior valor de 'bytes'
+} ResizableRing;
+
+/* Potência de dois >= n (mínimo 2) */
+static inline unsigned resizableRoundPow2(int n) {
+    unsigned cap = 2;
+    while (cap < (unsigned)n) {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+/* Alocação de um bloco, com contabilidade de memória */
+static inline ResizableBlock *resizableNewBlock(ResizableRing *r, unsigned cap, unsigned base) {
+    size_t tamanho = sizeof(ResizableBlock) + cap * sizeof(int);
+    ResizableBlock *b = (ResizableBlock *)malloc(tamanho);
+    if (b == NULL) {
+        return NULL;
+    }
+    b->older = NULL;
+    b->base = base;
+    b->mask = cap - 1;
+    size_t total = atomic_fetch_add_explicit(&r->bytes, tamanho, memory_order_relaxed) + tamanho;
+    if (total > atomic_load_explicit(&r->peakBytes, memory_order_relaxed)) {
+        atomic_store_explicit(&r->peakBytes, total, memory_order_relaxed);
+    }
+    return b;
+}
+
+/* Liberação de uma cadeia de blocos */
+static inline void resizableFreeChain(ResizableRing *r, ResizableBlock *b) {
+    while (b) {
+        ResizableBlock *older = b->older;
+        atomic_fetch_sub_explicit(&r->bytes, sizeof(ResizableBlock) + (b->mask + 1) * sizeof(int),
+                                  memory_order_relaxed);
+        free(b);
+        b = older;
+    }
+}
+
+/*
+ * Inicialização do buffer. As capacidades são arredondadas para potência
+ * de dois. Retorna 0 se a alocação falhar.
+ */
+static inline int initializeResizableRing(ResizableRing *r, int capacidadeMin, int capacidadeMax) {
+    unsigned min = resizableRoundPow2(capacidadeMin);
+    unsigned max = resizableRoundPow2(capacidadeMax);
+    if (max < min) {
+        max = min;
+    }
+    r->minCapacity = (int)min;
+    r->maxCapacity = (int)max;
+    atomic_init(&r->front, 0);
+    atomic_init(&r->rear, 0);
+    atomic_init(&r->grows, 0);
+    atomic_init(&r->shrinks, 0);
+    atomic_init(&r->drops, 0);
+    atomic_init(&r->bytes, 0);
+    atomic_init(&r->peakBytes, 0);
+    ResizableBlock *b = resizableNewBlock(r, min, 0);
+    if (b == NULL) {
+        return 0;
+    }
+    r->producerBlock = b;
+    r->consumerBlock = b;
+    atomic_init(&r->block, b);
+    return 1;
+}
+
+/* Liberação do buffer (sem produtor nem consumidor ativos) */
+static inline void releaseResizableRing(ResizableRing *r) {
+    ResizableBlock *b = atomic_load_explicit(&r->block, memory_order_acquire);
+    if (b != r->consumerBlock) {
+        resizableFreeChain(r, b->older);  // Inclui o bloco do consumidor
+        b->older = NULL;
+    }
+    resizableFreeChain(r, b);
+    r->producerBlock = r->consumerBlock = NULL;
+}
+
+/* Capacidade atual (lado do produtor) */
+static inline int resizableCapacity(ResizableRing *r) {
+    return (int)(r->producerBlock->mask + 1);
+}
+
+/* Número de itens no buffer */
+static inline int resizableCount(ResizableRing *r) {
+    return (int)(atomic_load_explicit(&r->front, memory_order_acquire) -
+                 atomic_load_explicit(&r->rear, memory_order_acquire));
+}
+
+/*
+ * Troca do bloco do produtor por um de 'cap' posições, copiando os itens
+ * [rear, front) para o início do bloco novo. Itens que o consumidor
+ * remover durante a cópia são copiados à toa, sem prejuízo.
+ */
+static inline int resizableMigrate(ResizableRing *r, unsigned cap, unsigned front, unsigned rear) {
+    ResizableBlock *antigo = r->producerBlock;
+    ResizableBlock *novo = resizableNewBlock(r, cap, rear);
+    if (novo == NULL) {
+        return 0;
+    }
+    unsigned n = front - rear;
+    unsigned pos = (rear - antigo->base) & antigo->mask;
+    unsigned primeiro = antigo->mask + 1 - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    memcpy(&novo->data[0], &antigo->data[pos], primeiro * sizeof(int));
+    memcpy(&novo->data[primeiro], &antigo->data[0], (n - primeiro) * sizeof(int));
+    novo->older = antigo;
+    atomic_store_explicit(&r->block, novo, memory_order_release);
+    r->producerBlock = novo;
+    return 1;
+}
+
+/*
+ * Inserção de um item (somente o produtor).
+ * Cresce quando cheio; retorna 0 se já estiver em maxCapacity (ou se a
+ * alocação falhar) e o item for descartado.
+ */
+static inline int resizableInsertItem(ResizableRing *r, int item) {
+    unsigned front = atomic_load_explicit(&r->front, memory_order_relaxed);
+    unsigned rear = atomic_load_explicit(&r->rear, memory_order_acquire);
+    unsigned cap = r->producerBlock->mask + 1;
+    unsigned n = front - rear;
+    if (n == cap) {
+        if (cap * 2 > (unsigned)r->maxCapacity || !resizableMigrate(r, cap * 2, front, rear)) {
+            bufferCounterAdd(&r->drops, 1);
+            return 0;
+        }
+        bufferCounterAdd(&r->grows, 1);
+    } else if (cap > (unsigned)r->minCapacity && n < cap / 4) {
+        if (resizableMigrate(r, cap / 2, front, rear)) {
+            bufferCounterAdd(&r->shrinks, 1);
+        }
+    }
+    ResizableBlock *b = r->producerBlock;
+    b->data[(front - b->base) & b->mask] = item;
+    atomic_store_explicit(&r->front, front + 1, memory_order_release);
+    return 1;
+}
+
+/* Remoção de um item (somente o consumidor). Retorna 0 se estiver vazio. */
+static inline int resizableRemoveItem(ResizableRing *r, int *item) {
+    unsigned rear = atomic_load_explicit(&r->rear, memory_order_relaxed);
+    unsigned front = atomic_load_explicit(&r->front, memory_order_acquire);
+    if (front == rear) {
+        return 0;
+    }
+    /* Lido depois de 'front': o bloco que contém o item já foi publicado */
+    ResizableBlock *b = atomic_load_explicit(&r->block, memory_order_acquire);
+    if (b != r->consumerBlock) {
+        resizableFreeChain(r, b->older);
+        b->older = NULL;
+        r->consumerBlock = b;
+    }
+    *item = b->data[(rear - b->base) & b->mask];
+    atomic_store_explicit(&r->rear, rear + 1, memory_order_release);
+    return 1;
+}
+
+#endif /* RESIZABLE_RING_H */
@@ -0,0 +1,354 @@
+/*--------------------------------------------------------------------------
+Esvaziamento de um CircularBuffer para um arquivo ou socket (Linux).
+
+drainBuffer entrega os (até dois) trechos contíguos ocupados do buffer
+diretamente ao writev, sem copiar para um vetor temporário, e avança
+'rear' pelo que foi de fato gravado. Gravações parciais que terminam no
+meio de um item ficam registradas em BufferDrain.partial.
+
+Opcionalmente (se <linux/io_uring.h> estiver disponível) há um caminho
+assíncrono com io_uring, sem liburing:
+
+    UringDrain u;
+    uringDrainInit(&u, fd, 0);           // deslocamento inicial no arquivo
+    uringDrainSubmit(&u, buf);           // enfileira um WRITEV (sem syscall)
+    uringDrainWait(&u, buf, 1);          // uma syscall: envia e colhe
+
+'rear' só avança quando a gravação correspondente é concluída, e só
+pelos bytes de fato gravados, então o produtor não sobrescreve dados em
+voo (não use BUFFER_OVERWRITE com esse caminho). Para sockets/pipes use
+deslocamento -1 e profundidade 1, pois várias gravações em voo podem ser
+concluídas fora de ordem.
+
+Uma gravação que falha ou fica curta registra o erro em u->error e fica,
+com as seguintes, no buffer; novas submissões são recusadas. Espere as
+gravações em voo (uringDrainWait até u->count == 0) e chame
+uringDrainRetry para tentar de novo a partir de 'rear', ou copie
+u->partial para BufferDrain.partial e siga com drainBuffer.
+----------------------------------------------------------------------------*/
+
+#ifndef RING_DRAIN_H
+#define RING_DRAIN_H
+
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "BufferCircular.h"
+
+/* Estado do esvaziamento síncrono */
+typedef struct {
+    int fd;                   // Destino
+    size_t partial;           // Bytes do item em 'rear' já gravados
+    unsigned long syscalls;   // Chamadas de sistema feitas
+} BufferDrain;
+
+/* Monta os iovecs dos itens a partir de 'inicio' itens depois de 'rear' */
+static inline int drainSegments(CircularBuffer *buf, int inicio, int n, size_t pular,
+                                struct iovec iov[2]) {
+    unsigned indice = buf->rear + (unsigned)inicio;
+    if (!buf->mask && indice >= (unsigned)buf->capacity) {
+        indice -= buf->capacity;
+    }
+    int pos = bufferSlot(buf, indice);
+    int primeiro = buf->mirrored ? n : buf->capacity - pos;
+    if (primeiro > n) {
+        primeiro = n;
+    }
+    iov[0].iov_base = (char *)&buf->data[pos] + pular;
+    iov[0].iov_len = primeiro * sizeof(int) - pular;
+    if (n > primeiro) {
+        iov[1].iov_base = &buf->data[0];
+        iov[1].iov_len = (n - primeiro) * sizeof(int);
+        return 2;
+    }
+    return 1;
+}
+
+/* Inicialização do esvaziamento síncrono */
+static inline void initializeDrain(BufferDrain *d, int fd) {
+    d->fd = fd;
+    d->partial = 0;
+    d->syscalls = 0;
+}
+
+/*
+ * Grava todo o conteúdo do buffer com um único writev.
+ * Retorna o número de bytes gravados, 0 se o buffer estiver vazio ou -1
+ * em caso de erro (errno preservado).
+ */
+static inline ssize_t drainBuffer(BufferDrain *d, CircularBuffer *buf) {
+    int n = bufferCount(buf);
+    if (n == 0) {
+        return 0;
+    }
+    struct iovec iov[2];
+    int iovcnt = drainSegments(buf, 0, n, d->partial, iov);
+    ssize_t gravados;
+    do {
+        gravados = writev(d->fd, iov, iovcnt);
+        d->syscalls++;
+    } while (gravados < 0 && errno == EINTR);
+    if (gravados <= 0) {
+        return gravados;
+    }
+    size_t total = d->partial + (size_t)gravados;
+    int itens = (int)(total / sizeof(int));
+    d->partial = total % sizeof(int);
+    if (itens > 0) {
+        advanceRear(buf, itens);
+    }
+    return gravados;
+}
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+
+#include <linux/io_uring.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef URING_DRAIN_DEPTH
+#define URING_DRAIN_DEPTH 8
+#endif
+
+/* Gravação submetida e ainda não descontada de 'rear' */
+typedef struct {
+    struct iovec iov[2];  // Devem continuar válidos até a conclusão
+    int items;
+    size_t skip;          // Bytes do primeiro item já gravados antes
+    size_t bytes;
+    int64_t offset;       // Deslocamento da gravação (-1 = stream)
+    int res;              // Resultado da conclusão
+    int done;
+    int stale;            // Submetida antes de uma falha: só é descartada
+} UringDrainWrite;
+
+/* Estado do esvaziamento assíncrono com io_uring */
+typedef struct {
+    int ringFd;
+    int fd;
+    int64_t offset;             // Próximo deslocamento no arquivo (-1 = posição atual/stream)
+    void *sqPtr, *cqPtr;
+    size_t sqSize, cqSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+    unsigned queued;            // SQEs preenchidos ainda não enviados ao kernel
+    UringDrainWrite writes[URING_DRAIN_DEPTH];
+    unsigned head, count;       // Fila de gravações em voo (ordem de submissão)
+    int submittedItems;         // Itens depois de 'rear' já submetidos
+    size_t partial;             // Bytes do item em 'rear' já gravados
+    unsigned long syscalls;     // Chamadas de sistema feitas
+    int error;                  // errno da primeira falha (0 = nenhuma)
+} UringDrain;
+
+/*
+ * Criação do io_uring. Retorna 0 ou -1 se o kernel não suportar (nesse
+ * caso use drainBuffer).
+ */
+static inline int uringDrainInit(UringDrain *u, int fd, int64_t deslocamento) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(u, 0, sizeof(*u));
+    u->fd = fd;
+    u->offset = deslocamento;
+    u->ringFd = (int)syscall(__NR_io_uring_setup, URING_DRAIN_DEPTH, &p);
+    if (u->ringFd < 0) {
+        return -1;
+    }
+    u->sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->cqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cqSize > u->sqSize) {
+            u->sqSize = u->cqSize;
+        }
+        u->cqSize = 0;
+    }
+    u->sqPtr = mmap(NULL, u->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    u->ringFd, IORING_OFF_SQ_RING);
+    if (u->sqPtr == MAP_FAILED) {
+        close(u->ringFd);
+        return -1;
+    }
+    u->cqPtr = u->sqPtr;
+    if (u->cqSize) {
+        u->cqPtr = mmap(NULL, u->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        u->ringFd, IORING_OFF_CQ_RING);
+        if (u->cqPtr == MAP_FAILED) {
+            munmap(u->sqPtr, u->sqSize);
+            close(u->ringFd);
+            return -1;
+        }
+    }
+    u->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = (struct io_uring_sqe *)mmap(NULL, u->sqesSize, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, u->ringFd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+        munmap(u->sqPtr, u->sqSize);
+        if (u->cqSize) munmap(u->cqPtr, u->cqSize);
+        close(u->ringFd);
+        return -1;
+    }
+    uint8_t *sq = (uint8_t *)u->sqPtr, *cq = (uint8_t *)u->cqPtr;
+    u->sqHead = (unsigned *)(sq + p.sq_off.head);
+    u->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    u->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+    u->sqArray = (unsigned *)(sq + p.sq_off.array);
+    u->cqHead = (unsigned *)(cq + p.cq_off.head);
+    u->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    u->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return 0;
+}
+
+/* Liberação do io_uring (espere as gravações em voo antes) */
+static inline void uringDrainRelease(UringDrain *u) {
+    munmap(u->sqes, u->sqesSize);
+    if (u->cqSize) munmap(u->cqPtr, u->cqSize);
+    munmap(u->sqPtr, u->sqSize);
+    close(u->ringFd);
+}
+
+/*
+ * Enfileira um WRITEV com os itens ainda não submetidos (sem syscall).
+ * Retorna o número de itens enfileirados (0 se não houver itens novos
+ * ou se já houver URING_DRAIN_DEPTH gravações em voo).
+ */
+static inline int uringDrainSubmit(UringDrain *u, CircularBuffer *buf) {
+    int n = bufferCount(buf) - u->submittedItems;
+    if (n <= 0 || u->count == URING_DRAIN_DEPTH || u->error) {
+        return 0;
+    }
+    unsigned slot = (u->head + u->count) % URING_DRAIN_DEPTH;
+    UringDrainWrite *w = &u->writes[slot];
+    w->skip = u->submittedItems == 0 ? u->partial : 0;
+    int iovcnt = drainSegments(buf, u->submittedItems, n, w->skip, w->iov);
+    w->items = n;
+    w->bytes = (size_t)n * sizeof(int) - w->skip;
+    w->offset = u->offset;
+    w->done = 0;
+    w->stale = 0;
+
+    unsigned tail = atomic_load_explicit((_Atomic unsigned *)u->sqTail, memory_order_relaxed);
+    unsigned indice = tail & *u->sqMask;
+    struct io_uring_sqe *sqe = &u->sqes[indice];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = u->fd;
+    sqe->addr = (uint64_t)(uintptr_t)w->iov;
+    sqe->len = (unsigned)iovcnt;
+    sqe->off = (uint64_t)u->offset;
+    sqe->user_data = slot;
+    u->sqArray[indice] = indice;
+    atomic_store_explicit((_Atomic unsigned *)u->sqTail, tail + 1, memory_order_release);
+
+    if (u->offset >= 0) {
+        u->offset += (int64_t)w->bytes;
+    }
+    u->count++;
+    u->queued++;
+    u->submittedItems += n;
+    return n;
+}
+
+/*
+ * Falha ou gravação curta em 'w' (a mais antiga em voo): desconta de
+ * 'rear' só os bytes gravados; o resto dela e as gravações seguintes
+ * ficam no buffer, e as que ainda estão em voo serão só descartadas.
+ */
+static inline void uringDrainFail(UringDrain *u, CircularBuffer *buf, UringDrainWrite *w) {
+    size_t gravados = w->res > 0 ? (size_t)w->res : 0;
+    if (!u->error) {
+        u->error = w->res < 0 ? -w->res : EIO;  // Curta deixaria um buraco no arquivo
+    }
+    size_t total = w->skip + gravados;
+    if (total / sizeof(int) > 0) {
+        advanceRear(buf, (int)(total / sizeof(int)));
+    }
+    u->partial = total % sizeof(int);
+    if (u->offset >= 0) {
+        u->offset = w->offset + (int64_t)gravados;
+    }
+    u->submittedItems = 0;
+    for (unsigned i = 1; i < u->count; i++) {
+        u->writes[(u->head + i) % URING_DRAIN_DEPTH].stale = 1;
+    }
+}
+
+/* Colhe as conclusões disponíveis e avança 'rear' pelo prefixo concluído */
+static inline void uringDrainReap(UringDrain *u, CircularBuffer *buf) {
+    unsigned head = atomic_load_explicit((_Atomic unsigned *)u->cqHead, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit((_Atomic unsigned *)u->cqTail, memory_order_acquire);
+    while (head != tail) {
+        struct io_uring_cqe *cqe = &u->cqes[head & *u->cqMask];
+        UringDrainWrite *w = &u->writes[cqe->user_data];
+        w->res = cqe->res;
+        w->done = 1;
+        head++;
+    }
+    atomic_store_explicit((_Atomic unsigned *)u->cqHead, head, memory_order_release);
+
+    while (u->count && u->writes[u->head].done) {
+        UringDrainWrite *w = &u->writes[u->head];
+        if (!w->stale) {
+            if (w->res >= 0 && (size_t)w->res == w->bytes) {
+                advanceRear(buf, w->items);
+                u->submittedItems -= w->items;
+                u->partial = 0;
+            } else {
+                uringDrainFail(u, buf, w);
+            }
+        }
+        u->head = (u->head + 1) % URING_DRAIN_DEPTH;
+        u->count--;
+    }
+}
+
+/*
+ * Depois de uma falha, volta a aceitar submissões a partir de 'rear'.
+ * Retorna -1 (sem mudar nada) se ainda houver gravações em voo.
+ */
+static inline int uringDrainRetry(UringDrain *u) {
+    if (u->count) {
+        return -1;
+    }
+    u->error = 0;
+    return 0;
+}
+
+/*
+ * Envia ao kernel o que foi enfileirado e espera ao menos 'minimo'
+ * conclusões, tudo em uma única syscall; depois colhe as conclusões.
+ * Retorna 0 ou -1 (errno em u->error).
+ */
+static inline int uringDrainWait(UringDrain *u, CircularBuffer *buf, unsigned minimo) {
+    if (minimo > u->count) {
+        minimo = u->count;
+    }
+    if (u->queued || minimo) {
+        int r;
+        do {
+            r = (int)syscall(__NR_io_uring_enter, u->ringFd, u->queued, minimo,
+                             minimo ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+            u->syscalls++;
+        } while (r < 0 && errno == EINTR);
+        if (r < 0) {
+            if (!u->error) u->error = errno;
+            return -1;
+        }
+        u->queued -= (unsigned)r;
+    }
+    uringDrainReap(u, buf);
+    return u->error ? -1 : 0;
+}
+
+#endif /* __has_include(<linux/io_uring.h>) */
+#endif /* __linux__ */
+
+#endif /* RING_DRAIN_H */
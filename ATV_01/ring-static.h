@@ -0,0 +1,73 @@
+/*--------------------------------------------------------------------------
+Buffer circular genérico, com tipo e capacidade fixados em tempo de
+compilação e sem uso de heap.
+
+RING_DECLARE(Nome, tipo, capacidade) gera o tipo 'Nome' e as funções
+NomeInit, NomeCount, NomeIsFull, NomeIsEmpty, NomeInsert e NomeRemove.
+Os dados ficam dentro da própria estrutura, então a instância pode ser
+global/estática ou ficar na pilha:
+
+    RING_DECLARE(ByteRing, uint8_t, 64)
+    static ByteRing rx;          // zerada = vazia, NomeInit é opcional
+
+    ByteRingInsert(&rx, c);
+
+A capacidade precisa ser uma potência de dois: os índices correm livres e
+são mascarados com (capacidade - 1), que o compilador conhece, assim como
+sizeof(tipo). Os índices vêm antes de 'data' para ficarem ao alcance do
+deslocamento imediato curto de ldr/str no Thumb. Diferente de
+initializeBuffer, nada aqui chama malloc, o que evita trazer o heap da
+newlib (_sbrk) para os alvos SAMD21.
+----------------------------------------------------------------------------*/
+
+#ifndef RING_STATIC_H
+#define RING_STATIC_H
+
+#define RING_DECLARE(Nome, tipo, capacidade)                                  \
+    _Static_assert((capacidade) > 0 && ((capacidade) & ((capacidade) - 1)) == 0, \
+                   #Nome ": capacidade deve ser potência de dois");          \
+                                                                              \
+    typedef struct {                                                          \
+        unsigned front;        /* Índice livre de inserção */                 \
+        unsigned rear;         /* Índice livre de remoção */                  \
+        tipo data[capacidade]; /* Dados armazenados no buffer */              \
+    } Nome;                                                                   \
+                                                                              \
+    static inline void Nome##Init(Nome *r) {                                  \
+        r->front = 0;                                                         \
+        r->rear = 0;                                                          \
+    }                                                                         \
+                                                                              \
+    static inline unsigned Nome##Count(const Nome *r) {                       \
+        return r->front - r->rear;                                            \
+    }                                                                         \
+                                                                              \
+    static inline int Nome##IsFull(const Nome *r) {                           \
+        return r->front - r->rear == (capacidade);                            \
+    }                                                                         \
+                                                                              \
+    static inline int Nome##IsEmpty(const Nome *r) {                          \
+        return r->front == r->rear;                                           \
+    }                                                                         \
+                                                                              \
+    /* Retorna 0 se o buffer estiver cheio */                                 \
+    static inline int Nome##Insert(Nome *r, tipo item) {                      \
+        if (Nome##IsFull(r)) {                                                \
+            return 0;                                                         \
+        }                                                                     \
+        r->data[r->front & ((capacidade) - 1)] = item;                        \
+        r->front++;                                                           \
+        return 1;                                                             \
+    }                                                                         \
+                                                                              \
+    /* Retorna 0 se o buffer estiver vazio */                                 \
+    static inline int Nome##Remove(Nome *r, tipo *item) {                     \
+        if (Nome##IsEmpty(r)) {                                               \
+            return 0;                                                         \
+        }                                                                     \
+        *item = r->data[r->rear & ((capacidade) - 1)];                        \
+        r->rear++;                                                            \
+        return 1;                                                             \
+    }
+
+#endif /* RING_STATIC_H */
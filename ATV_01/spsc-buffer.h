@@ -0,0 +1,105 @@
+/*--------------------------------------------------------------------------
+Buffer circular sem trava para um único produtor e um único consumidor
+(SPSC).
+
+O produtor é o único que escreve em 'front' e o consumidor é o único que
+escreve em 'rear'; não existe contador 'size' compartilhado. A publicação
+dos dados usa atomics do C11 com semântica acquire/release, então o mesmo
+código serve para ISR -> tarefa no Cortex-M0+ (apenas loads/stores de 32
+bits, sem read-modify-write) e para duas threads no host.
+
+Cada índice fica na sua própria linha de cache, junto com a cópia local
+que o dono mantém do índice do outro lado, para que produtor e consumidor
+não invalidem a linha um do outro a cada operação.
+
+O buffer reserva uma posição a mais que 'capacity' para distinguir cheio
+de vazio sem precisar de contador.
+----------------------------------------------------------------------------*/
+
+#ifndef SPSC_BUFFER_H
+#define SPSC_BUFFER_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64
+#endif
+
+/* Estrutura que representa um buffer circular SPSC */
+typedef struct {
+    alignas(SPSC_CACHE_LINE) atomic_int front; // Índice de inserção (produtor)
+    int rearCache;                             // Última leitura de 'rear' feita pelo produtor
+
+    alignas(SPSC_CACHE_LINE) atomic_int rear;  // Índice de remoção (consumidor)
+    int frontCache;                            // Última leitura de 'front' feita pelo consumidor
+
+    alignas(SPSC_CACHE_LINE) int *data;        // Dados (somente leitura após a criação)
+    int slots;                                 // capacity + 1
+    int capacity;                              // Capacidade útil do buffer
+} SpscBuffer;
+
+/* Criação de um novo buffer SPSC */
+static inline SpscBuffer* initializeSpscBuffer(int capacidade) {
+    size_t tamanho = (sizeof(SpscBuffer) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    SpscBuffer *buf = (SpscBuffer *)aligned_alloc(SPSC_CACHE_LINE, tamanho);
+    buf->data = (int *)malloc((capacidade + 1) * sizeof(int));
+    buf->slots = capacidade + 1;
+    buf->capacity = capacidade;
+    atomic_init(&buf->front, 0);
+    atomic_init(&buf->rear, 0);
+    buf->rearCache = 0;
+    buf->frontCache = 0;
+    return buf;
+}
+
+/* Liberação da memória do buffer */
+static inline void releaseSpscBuffer(SpscBuffer *buf) {
+    free(buf->data);
+    free(buf);
+}
+
+/* Inserção de um item (somente o produtor). Retorna 0 se estiver cheio. */
+static inline int spscInsertItem(SpscBuffer *buf, int item) {
+    int front = atomic_load_explicit(&buf->front, memory_order_relaxed);
+    int next = front + 1;
+    if (next == buf->slots) {
+        next = 0;
+    }
+    if (next == buf->rearCache) {
+        buf->rearCache = atomic_load_explicit(&buf->rear, memory_order_acquire);
+        if (next == buf->rearCache) {
+            return 0;
+        }
+    }
+    buf->data[front] = item;
+    atomic_store_explicit(&buf->front, next, memory_order_release);
+    return 1;
+}
+
+/* Remoção de um item (somente o consumidor). Retorna 0 se estiver vazio. */
+static inline int spscRemoveItem(SpscBuffer *buf, int *item) {
+    int rear = atomic_load_explicit(&buf->rear, memory_order_relaxed);
+    if (rear == buf->frontCache) {
+        buf->frontCache = atomic_load_explicit(&buf->front, memory_order_acquire);
+        if (rear == buf->frontCache) {
+            return 0;
+        }
+    }
+    *item = buf->data[rear];
+    int next = rear + 1;
+    if (next == buf->slots) {
+        next = 0;
+    }
+    atomic_store_explicit(&buf->rear, next, memory_order_release);
+    return 1;
+}
+
+/* Checa se o buffer está vazio (visão aproximada se chamada fora do consumidor) */
+static inline int isSpscBufferEmpty(SpscBuffer *buf) {
+    return atomic_load_explicit(&buf->front, memory_order_acquire) ==
+           atomic_load_explicit(&buf->rear, memory_order_acquire);
+}
+
+#endif /* SPSC_BUFFER_H */
@@ -0,0 +1,137 @@
+/*--------------------------------------------------------------------------
+Janela deslizante com mínimo, máximo e média em O(1).
+
+Em vez de guardar as últimas N amostras em um CircularBuffer e varrer o
+buffer inteiro a cada relatório, WINDOW_DECLARE gera uma janela que
+mantém os agregados durante a inserção e a remoção:
+
+  - soma corrente (a média é soma / quantidade);
+  - duas filas monotônicas com as posições dos candidatos a mínimo e a
+    máximo. Cada amostra entra e sai de cada fila no máximo uma vez, então
+    o custo amortizado por amostra é constante e as consultas só leem a
+    cabeça da fila.
+
+WINDOW_DECLARE(Nome, tipo, tipoSoma, capacidade) gera o tipo 'Nome' e as
+funções NomeInit, NomeCount, NomeIsFull, NomeIsEmpty, NomeInsert,
+NomeRemove, NomeMin, NomeMax, NomeSum e NomeMean. 'tipo' é qualquer tipo
+inteiro; ponto fixo funciona igual (ex.: int16_t em Q8.8, com a média
+também em Q8.8). 'tipoSoma' precisa comportar capacidade * tipo:
+
+    WINDOW_DECLARE(Temperatura, int16_t, int32_t, 64)
+    static Temperatura janela;       // zerada = vazia
+
+    TemperaturaInsert(&janela, leitura);   // Cheia: descarta a mais antiga
+    relatar(TemperaturaMin(&janela), TemperaturaMax(&janela), TemperaturaMean(&janela));
+
+Como em ring-static.h, a capacidade é potência de dois e nada usa heap.
+As filas guardam a posição em 'data' (uint16_t), o que custa 4 bytes a
+mais por amostra. Com a janela cheia a média divide por uma constante
+potência de dois, que vira deslocamento; no Cortex-M0+ isso evita a
+chamada a __aeabi_idiv em cada consulta.
+----------------------------------------------------------------------------*/
+
+#ifndef WINDOW_RING_H
+#define WINDOW_RING_H
+
+#include <stdint.h>
+
+#define WINDOW_DECLARE(Nome, tipo, tipoSoma, capacidade)                      \
+    _Static_assert((capacidade) > 0 && ((capacidade) & ((capacidade) - 1)) == 0, \
+                   #Nome ": capacidade deve ser potência de dois");          \
+    _Static_assert((capacidade) <= 65536, #Nome ": capacidade máxima 65536");   \
+                                                                              \
+    typedef struct {                                                          \
+        unsigned front;              /* Índice livre de inserção */           \
+        unsigned rear;               /* Índice livre de remoção */            \
+        unsigned minHead, minTail;   /* Fila de candidatos a mínimo */        \
+        unsigned maxHead, maxTail;   /* Fila de candidatos a máximo */        \
+        tipoSoma sum;                /* Soma das amostras na janela */        \
+        tipo data[capacidade];                                                \
+        uint16_t minSlot[capacidade]; /* Posições em 'data', crescentes */    \
+        uint16_t maxSlot[capacidade]; /* Posições em 'data', decrescentes */  \
+    } Nome;                                                                   \
+                                                                              \
+    static inline void Nome##Init(Nome *w) {                                  \
+        w->front = w->rear = 0;                                               \
+        w->minHead = w->minTail = 0;                                          \
+        w->maxHead = w->maxTail = 0;                                          \
+        w->sum = 0;                                                           \
+    }                                                                         \
+                                                                              \
+    static inline unsigned Nome##Count(const Nome *w) {                       \
+        return w->front - w->rear;                                            \
+    }                                                                         \
+                                                                              \
+    static inline int Nome##IsFull(const Nome *w) {                           \
+        return w->front - w->rear == (capacidade);                            \
+    }                                                                         \
+                                                                              \
+    static inline int Nome##IsEmpty(const Nome *w) {                          \
+        return w->front == w->rear;                                           \
+    }                                                                         \
+                                                                              \
+    /* Remoção da amostra mais antiga. Retorna 0 se a janela estiver vazia */ \
+    static inline int Nome##Remove(Nome *w, tipo *item) {                     \
+        if (Nome##IsEmpty(w)) {                                               \
+            return 0;                                                         \
+        }                                                                     \
+        unsigned slot = w->rear & ((capacidade) - 1);                         \
+        if (w->minSlot[w->minHead & ((capacidade) - 1)] == slot) {            \
+            w->minHead++;                                                     \
+        }                                                                     \
+        if (w->maxSlot[w->maxHead & ((capacidade) - 1)] == slot) {            \
+            w->maxHead++;                                                     \
+        }                                                                     \
+        *item = w->data[slot];                                                \
+        w->sum -= w->data[slot];                                              \
+        w->rear++;                                                            \
+        return 1;                                                             \
+    }                                                                         \
+                                                                              \
+    /* Inserção de uma amostra; com a janela cheia descarta a mais antiga.    \
+       Retorna 1 se uma amostra foi descartada. */                            \
+    static inline int Nome##Insert(Nome *w, tipo item) {                      \
+        int descartou = 0;                                                    \
+        if (Nome##IsFull(w)) {                                                \
+            tipo antigo;                                                      \
+            Nome##Remove(w, &antigo);                                         \
+            descartou = 1;                                                    \
+        }                                                                     \
+        unsigned slot = w->front & ((capacidade) - 1);                        \
+        while (w->minTail != w->minHead &&                                    \
+               w->data[w->minSlot[(w->minTail - 1) & ((capacidade) - 1)]] >= item) { \
+            w->minTail--;                                                     \
+        }                                                                     \
+        w->minSlot[w->minTail++ & ((capacidade) - 1)] = (uint16_t)slot;       \
+        while (w->maxTail != w->maxHead &&                                    \
+               w->data[w->maxSlot[(w->maxTail - 1) & ((capacidade) - 1)]] <= item) { \
+            w->maxTail--;                                                     \
+        }                                                                     \
+        w->maxSlot[w->maxTail++ & ((capacidade) - 1)] = (uint16_t)slot;       \
+        w->data[slot] = item;                                                 \
+        w->sum += item;                                                       \
+        w->front++;                                                           \
+        return descartou;                                                     \
+    }                                                                         \
+                                                                              \
+    /* Consultas: a janela não pode estar vazia */                            \
+    static inline tipo Nome##Min(const Nome *w) {                             \
+        return w->data[w->minSlot[w->minHead & ((capacidade) - 1)]];          \
+    }                                                                         \
+                                                                              \
+    static inline tipo Nome##Max(const Nome *w) {                             \
+        return w->data[w->maxSlot[w->maxHead & ((capacidade) - 1)]];          \
+    }                                                                         \
+                                                                              \
+    static inline tipoSoma Nome##Sum(const Nome *w) {                         \
+        return w->sum;                                                        \
+    }                                                                         \
+                                                                              \
+    static inline tipo Nome##Mean(const Nome *w) {                            \
+        if (Nome##IsFull(w)) {                                                \
+            return (tipo)(w->sum / (tipoSoma)(capacidade));                   \
+        }                                                                     \
+        return (tipo)(w->sum / (tipoSoma)Nome##Count(w));                     \
+    }
+
+#endif /* WINDOW_RING_H */
@@ -1,71 +1,14 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
-// Definição dos estados da máquina de estados
-typedef enum {
-    ESPERANDO_STX,      // Esperando pelo byte STX
-    LENDO_TAMANHO,      // Lendo o tamanho dos dados
-    LENDO_DADOS,        // Lendo os dados
-    LENDO_CHECKSUM,     // Lendo o checksum
-    ESPERANDO_ETX,      // Esperando pelo byte ETX
-    PROCESSO_COMPLETO,  // Processo concluído
-    PROCESSO_ERRO       // Erro no processamento
-} EstadoParser;
-
-// Estrutura da máquina de estados
-typedef struct {
-    EstadoParser estadoAtual; // Estado atual
-    uint8_t tamanho;          // Tamanho dos dados
-    uint8_t dados[256];       // Buffer para os dados
-    uint8_t checksum;         // Valor do checksum
-    uint8_t indiceDados;      // Índice atual no buffer de dados
-} MaquinaEstados;
-
-// Função para inicializar a máquina de estados
-void inicializarMaquina(MaquinaEstados *maquina) {
-    maquina->estadoAtual = ESPERANDO_STX;
-    maquina->tamanho = 0;
-    maquina->checksum = 0;
-    maquina->indiceDados = 0;
-}
-
-// Função para processar um byte na máquina de estados
-bool processarByte(MaquinaEstados *maquina, uint8_t byte) {
-    switch (maquina->estadoAtual) {
-        case ESPERANDO_STX:
-            if (byte == 0x02) { // STX
-                maquina->estadoAtual = LENDO_TAMANHO;
-            }
-            break;
-        case LENDO_TAMANHO:
-            maquina->tamanho = byte;
-            maquina->estadoAtual = LENDO_DADOS;
-            break;
-        case LENDO_DADOS:
-            maquina->dados[maquina->indiceDados++] = byte;
-            if (maquina->indiceDados == maquina->tamanho) {
-                maquina->estadoAtual = LENDO_CHECKSUM;
-            }
-            break;
-        case LENDO_CHECKSUM:
-            maquina->checksum = byte;
-            maquina->estadoAtual = ESPERANDO_ETX;
-            break;
-        case ESPERANDO_ETX:
-            if (byte == 0x03) { // ETX
-                maquina->estadoAtual = PROCESSO_COMPLETO;
-                return true;
-            } else {
-                maquina->estadoAtual = PROCESSO_ERRO;
-            }
-            break;
-        case PROCESSO_COMPLETO:
-        case PROCESSO_ERRO:
-            break;
-    }
-    return false;
-}
+#include "FSMswitchCase.h"
+#include "multi-channel.h"
+#include "parallel-decoder.h"
+
+// Testes que falharam (código de saída do programa)
+int falhas = 0;
 
 // Teste da máquina de estados usando TDD
 void testarMaquinaEstados() {
@@ -86,10 +29,551 @@ void testarMaquinaEstados() {
         printf("Máquina de estados completou com sucesso.\n");
     } else {
         printf("Máquina de estados falhou.\n");
+        falhas++;
+    }
+}
+
+// Contexto do teste em bloco: soma dos dados de todos os quadros recebidos
+typedef struct {
+    int quadros;
+    unsigned soma;
+} ResultadoBloco;
+
+static void contarQuadro(const MaquinaEstados *maquina, void *contexto) {
+    ResultadoBloco *r = (ResultadoBloco *)contexto;
+    r->quadros++;
+    for (size_t i = 0; i < maquina->quadro.len; i++) {
+        r->soma += maquina->quadro.ptr[i];
+    }
+}
+
+// Teste do processamento em bloco: ruído entre quadros, quadro vazio, ETX
+// errado e o fluxo entregue em pedaços que cortam os quadros no meio
+void testarProcessarBytes() {
+    uint8_t fluxo[] = {
+        0x55, 0xAA,                                   // ruído
+        0x02, 0x03, 'A', 'B', 'C', 0x05, 0x03,        // quadro válido
+        0x02, 0x00, 0x00, 0x03,                       // quadro sem dados
+        0x02, 0x02, 'X', 'Y', 0x00, 0x7F,             // ETX errado: descartado
+        0x01, 0x02, 0x04, 1, 2, 3, 4, 0x0A, 0x03      // ruído + quadro válido
+    };
+    ResultadoBloco esperado = {0, 0}, obtido = {0, 0};
+
+    MaquinaEstados maquina;
+    inicializarMaquina(&maquina);
+    for (size_t i = 0; i < sizeof(fluxo); i++) {
+        if (processarByte(&maquina, fluxo[i])) {
+            contarQuadro(&maquina, &esperado);
+        }
+    }
+
+    bool ok = esperado.quadros == 3;
+    for (size_t pedaco = 1; pedaco <= sizeof(fluxo) && ok; pedaco++) {
+        inicializarMaquina(&maquina);
+        obtido.quadros = 0;
+        obtido.soma = 0;
+        size_t quadros = 0;
+        for (size_t i = 0; i < sizeof(fluxo); i += pedaco) {
+            size_t n = sizeof(fluxo) - i < pedaco ? sizeof(fluxo) - i : pedaco;
+            quadros += processarBytes(&maquina, fluxo + i, n, contarQuadro, &obtido);
+        }
+        ok = quadros == 3 && obtido.quadros == esperado.quadros && obtido.soma == esperado.soma;
+    }
+
+    if (ok) {
+        printf("Processamento em bloco completou com sucesso.\n");
+    } else {
+        printf("Processamento em bloco falhou.\n");
+        falhas++;
+    }
+}
+
+// Monta um quadro com o checksum do algoritmo escolhido; retorna o tamanho
+static size_t montarQuadro(uint8_t *saida, ChecksumAlgorithm algoritmo, const uint8_t *dados, uint8_t n) {
+    size_t i = 0;
+    saida[i++] = STX;
+    saida[i++] = n;
+    memcpy(&saida[i], dados, n);
+    i += n;
+    uint16_t c = checksumUpdate(algoritmo, checksumInit(algoritmo), &saida[1], (size_t)n + 1);
+    if (checksumSize(algoritmo) == 2) {
+        saida[i++] = (uint8_t)(c >> 8);
+    }
+    saida[i++] = (uint8_t)c;
+    saida[i++] = ETX;
+    return i;
+}
+
+// Teste da verificação do checksum: kernels de CRC contra a referência bit
+// a bit e quadros corrompidos rejeitados nos dois caminhos da máquina
+void testarChecksum() {
+    uint8_t dados[200];
+    for (int i = 0; i < 200; i++) {
+        dados[i] = (uint8_t)(i * 37 + 11);
+    }
+    const uint8_t padrao[] = "123456789";
+    bool ok = crc8Bitwise(0, padrao, 9) == 0xF4 && crc16Bitwise(0xFFFF, padrao, 9) == 0x29B1;
+    for (size_t n = 0; n <= sizeof(dados) && ok; n++) {
+        uint8_t c8 = crc8Bitwise(0x5A, dados, n);
+        uint16_t c16 = crc16Bitwise(0xFFFF, dados, n);
+        ok = crc8Nibbles(0x5A, dados, n) == c8 && crc16Nibbles(0xFFFF, dados, n) == c16;
+#ifndef CHECKSUM_SMALL
+        ok = ok && crc8Slice(0x5A, dados, n, 4) == c8 && crc8Slice(0x5A, dados, n, 8) == c8 &&
+             crc16Slice(0xFFFF, dados, n, 4) == c16 && crc16Slice(0xFFFF, dados, n, 8) == c16;
+#endif
+    }
+
+    const ChecksumAlgorithm algoritmos[] = {CHECKSUM_SUM8, CHECKSUM_XOR8, CHECKSUM_CRC8, CHECKSUM_CRC16_CCITT};
+    for (size_t a = 0; a < 4 && ok; a++) {
+        uint8_t fluxo[2 * 210];
+        size_t n = montarQuadro(fluxo, algoritmos[a], dados, 150);
+        size_t total = n + montarQuadro(fluxo + n, algoritmos[a], dados, 150);
+        fluxo[n + 2 + 75] ^= 0x10;  // Corrompe um byte de dados do segundo quadro
+
+        MaquinaEstados maquina;
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, algoritmos[a]);
+        int porByte = 0;
+        for (size_t i = 0; i < total; i++) {
+            porByte += processarByte(&maquina, fluxo[i]);
+        }
+        bool rejeitou = maquina.estadoAtual == PROCESSO_ERRO;
+
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, algoritmos[a]);
+        size_t emBloco = processarBytes(&maquina, fluxo, 100, NULL, NULL);
+        emBloco += processarBytes(&maquina, fluxo + 100, total - 100, NULL, NULL);
+        ok = porByte == 1 && emBloco == 1 && rejeitou;
+    }
+
+    if (ok) {
+        printf("Verificação de checksum completou com sucesso.\n");
+    } else {
+        printf("Verificação de checksum falhou.\n");
+        falhas++;
+    }
+}
+
+// Contexto do teste da visão: onde estavam os dados de cada quadro
+typedef struct {
+    const uint8_t *ptr[2];
+    size_t len[2];
+    int quadros;
+} ResultadoVisao;
+
+static void guardarVisao(const MaquinaEstados *maquina, void *contexto) {
+    ResultadoVisao *r = (ResultadoVisao *)contexto;
+    if (r->quadros < 2) {
+        r->ptr[r->quadros] = maquina->quadro.ptr;
+        r->len[r->quadros] = maquina->quadro.len;
+    }
+    r->quadros++;
+}
+
+// Teste da visão sem cópia: quadro inteiro no bloco aponta para a entrada;
+// quadro que atravessa o fim do bloco usa o buffer interno
+void testarVisaoQuadro() {
+    uint8_t fluxo[] = {0x02, 0x03, 'A', 'B', 'C', 0x05, 0x03, 0x02, 0x04, 'W', 'X', 'Y', 'Z', 0x00, 0x03};
+    uint8_t copia[sizeof(fluxo)];
+    memcpy(copia, fluxo, sizeof(fluxo));
+    ResultadoVisao r = {{NULL, NULL}, {0, 0}, 0};
+
+    MaquinaEstados maquina;
+    inicializarMaquina(&maquina);
+    processarBytes(&maquina, copia, 10, guardarVisao, &r);  // Corta o 2º quadro nos dados
+    memset(copia, 0xEE, 10);                                // Quem chama reutiliza o bloco
+    processarBytes(&maquina, copia + 10, sizeof(fluxo) - 10, guardarVisao, &r);
+
+    bool ok = r.quadros == 2 &&
+              r.ptr[0] == copia + 2 && r.len[0] == 3 &&
+              r.ptr[1] == maquina.dados && r.len[1] == 4 && memcmp(maquina.dados, "WXYZ", 4) == 0;
+
+    // Dados completos mas ETX só no bloco seguinte: copiados ao fim da chamada
+    inicializarMaquina(&maquina);
+    r.quadros = 0;
+    memcpy(copia, fluxo, sizeof(fluxo));
+    processarBytes(&maquina, copia, 6, guardarVisao, &r);
+    memset(copia, 0xEE, 6);
+    processarBytes(&maquina, copia + 6, 1, guardarVisao, &r);
+    ok = ok && r.quadros == 1 && r.ptr[0] == maquina.dados && memcmp(maquina.dados, "ABC", 3) == 0;
+
+    if (ok) {
+        printf("Visão sem cópia completou com sucesso.\n");
+    } else {
+        printf("Visão sem cópia falhou.\n");
+        falhas++;
+    }
+}
+
+// Processa o fluxo em pedaços; retorna quadros e preenche 'soma' com a
+// soma dos dados de todos eles
+static size_t processarEmPedacos(MaquinaEstados *maquina, const uint8_t *fluxo, size_t total,
+                                 size_t pedaco, ResultadoBloco *r) {
+    size_t quadros = 0;
+    r->quadros = 0;
+    r->soma = 0;
+    for (size_t i = 0; i < total; i += pedaco) {
+        size_t n = total - i < pedaco ? total - i : pedaco;
+        quadros += processarBytes(maquina, fluxo + i, n, contarQuadro, r);
+    }
+    return quadros;
+}
+
+// Teste da ressincronização: dois quadros válidos escondidos nos dados de
+// um quadro falso são recuperados em qualquer divisão do fluxo, e um fluxo
+// com bits trocados dá o mesmo resultado em todos os tamanhos de pedaço
+void testarRessincronizacao() {
+    uint8_t fluxo[] = {
+        0x02, 0x0A,                                   // STX falso, tamanho 10
+        0x02, 0x01, 'A', 0x00, 0x03,                  // quadro válido
+        0x02, 0x02, 'B', 'C', 0x00, 0x03,             // quadro válido (o 0x03 é o "checksum" do falso)
+        0x55,                                         // no lugar do ETX do falso
+        0x02, 0x00, 0x00, 0x03                        // quadro válido depois do falso
+    };
+    MaquinaEstados maquina;
+    ResultadoBloco r;
+
+    // Sem ressincronização o quadro falso engole os dois primeiros
+    inicializarMaquina(&maquina);
+    bool ok = processarEmPedacos(&maquina, fluxo, sizeof(fluxo), sizeof(fluxo), &r) == 1 &&
+              maquina.bytesDescartados == 14 && maquina.quadrosRecuperados == 0;
+
+    for (size_t pedaco = 1; pedaco <= sizeof(fluxo) && ok; pedaco++) {
+        inicializarMaquina(&maquina);
+        configurarRessincronizacao(&maquina, true);
+        ok = processarEmPedacos(&maquina, fluxo, sizeof(fluxo), pedaco, &r) == 3 &&
+             r.soma == 'A' + 'B' + 'C' && maquina.quadrosRecuperados == 2 && maquina.bytesDescartados == 3;
+    }
+
+    // Fluxo com ruído: todo byte termina em quadro aceito ou descartado, e
+    // o resultado não depende de onde o fluxo é cortado
+    uint8_t ruidoso[3000];
+    size_t total = 0;
+    unsigned semente = 1;
+    while (total + 70 < sizeof(ruidoso)) {
+        uint8_t n = (uint8_t)(semente % 60);
+        uint8_t dados[60];
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            dados[k] = (uint8_t)(semente >> 16);
+        }
+        semente = semente * 1103515245u + 12345u;
+        total += montarQuadro(ruidoso + total, CHECKSUM_CRC8, dados, n);
+    }
+    for (size_t i = 0; i < total * 8; i++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 100 == 0) {
+            ruidoso[i / 8] ^= (uint8_t)(1u << (i % 8));  // 1% dos bits trocados
+        }
+    }
+
+    ResultadoBloco referencia;
+    inicializarMaquina(&maquina);
+    configurarChecksum(&maquina, CHECKSUM_CRC8);
+    configurarRessincronizacao(&maquina, true);
+    size_t quadros = processarEmPedacos(&maquina, ruidoso, total, total, &referencia);
+    size_t descartados = maquina.bytesDescartados, recuperados = maquina.quadrosRecuperados;
+    ok = ok && quadros > 0 && recuperados > 0;
+
+    for (size_t pedaco = 1; pedaco <= 300 && ok; pedaco++) {
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, CHECKSUM_CRC8);
+        configurarRessincronizacao(&maquina, true);
+        ok = processarEmPedacos(&maquina, ruidoso, total, pedaco, &r) == quadros && r.soma == referencia.soma &&
+             maquina.bytesDescartados == descartados && maquina.quadrosRecuperados == recuperados;
+    }
+
+    if (ok) {
+        printf("Ressincronização completou com sucesso.\n");
+    } else {
+        printf("Ressincronização falhou.\n");
+        falhas++;
+    }
+}
+
+// Teste da busca do STX: as três versões acham o mesmo STX que um laço
+// byte a byte em qualquer alinhamento, e numa captura com linha ociosa e
+// STX falsos o processarBytes (que pula os candidatos com ETX errado) dá
+// os mesmos quadros e contadores que a máquina vendo um byte por vez
+void testarBuscaStx() {
+    uint8_t bloco[300];
+    unsigned semente = 9;
+    for (size_t i = 0; i < sizeof(bloco); i++) {
+        semente = semente * 1103515245u + 12345u;
+        bloco[i] = (semente >> 16) % 40 == 0 ? STX : 0xFF;
+    }
+    bool ok = true;
+    for (size_t inicio = 0; inicio < 70 && ok; inicio++) {
+        for (size_t fim = inicio; fim <= sizeof(bloco) && ok; fim++) {
+            const uint8_t *esperado = NULL;
+            for (size_t i = inicio; i < fim && !esperado; i++) {
+                if (bloco[i] == STX) {
+                    esperado = &bloco[i];
+                }
+            }
+            ok = stxFindScalar(bloco + inicio, bloco + fim) == esperado;
+#if defined(__SSE2__) && !defined(STX_SCAN_SCALAR)
+            ok = ok && stxFindSse2(bloco + inicio, bloco + fim) == esperado;
+#endif
+#if defined(__AVX2__) && !defined(STX_SCAN_SCALAR)
+            ok = ok && stxFindAvx2(bloco + inicio, bloco + fim) == esperado;
+#endif
+        }
+    }
+
+    // Captura: linha ociosa (0xFF), quadros válidos e STX soltos no meio
+    // da linha ociosa; com pedaço 1 a busca nunca vê o ETX e tudo passa
+    // pela máquina
+    uint8_t captura[4000];
+    size_t total = 0;
+    while (total + 120 < sizeof(captura)) {
+        semente = semente * 1103515245u + 12345u;
+        size_t ocioso = (semente >> 16) % 40;
+        for (size_t k = 0; k < ocioso; k++) {
+            semente = semente * 1103515245u + 12345u;
+            captura[total++] = (semente >> 16) % 8 == 0 ? STX : 0xFF;
+        }
+        uint8_t n = (uint8_t)((semente >> 20) % 50);
+        uint8_t dados[50];
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            dados[k] = (uint8_t)(semente >> 16);
+        }
+        total += montarQuadro(captura + total, CHECKSUM_CRC8, dados, n);
+    }
+    for (int ressincronizar = 0; ressincronizar < 2 && ok; ressincronizar++) {
+        MaquinaEstados maquina;
+        ResultadoBloco referencia, r;
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, CHECKSUM_CRC8);
+        configurarRessincronizacao(&maquina, ressincronizar);
+        size_t quadros = processarEmPedacos(&maquina, captura, total, 1, &referencia);
+        size_t descartados = maquina.bytesDescartados, recuperados = maquina.quadrosRecuperados;
+        ok = quadros > 0 && descartados > 0;
+
+        const size_t pedacos[] = {total, 700, 64};
+        for (size_t k = 0; k < 3 && ok; k++) {
+            inicializarMaquina(&maquina);
+            configurarChecksum(&maquina, CHECKSUM_CRC8);
+            configurarRessincronizacao(&maquina, ressincronizar);
+            ok = processarEmPedacos(&maquina, captura, total, pedacos[k], &r) == quadros &&
+                 r.soma == referencia.soma && maquina.bytesDescartados == descartados &&
+                 maquina.quadrosRecuperados == recuperados;
+        }
+    }
+
+    if (ok) {
+        printf("Busca do STX completou com sucesso.\n");
+    } else {
+        printf("Busca do STX falhou.\n");
+        falhas++;
+    }
+}
+
+// Contexto do teste multicanal: quadros e soma dos dados por canal
+typedef struct {
+    int quadros[3];
+    unsigned soma[3];
+} ResultadoCanais;
+
+static void contarQuadroCanal(uint16_t canal, const uint8_t *dados, size_t tamanho, void *contexto) {
+    ResultadoCanais *r = (ResultadoCanais *)contexto;
+    r->quadros[canal]++;
+    for (size_t i = 0; i < tamanho; i++) {
+        r->soma[canal] += dados[i];
+    }
+}
+
+// Teste do parser multicanal: três canais com fluxos próprios, entregues
+// intercalados em pedaços de tamanho aleatório, dão o mesmo resultado de
+// uma MaquinaEstados por canal; com o pool pequeno demais os quadros sem
+// buffer são contados como perdidos, sem perder o sincronismo
+void testarMultiCanal() {
+    uint8_t fluxos[3][600];
+    size_t tamanhos[3] = {0, 0, 0};
+    ResultadoBloco esperado[3];
+    unsigned semente = 5;
+    for (int c = 0; c < 3; c++) {
+        while (tamanhos[c] + 60 < sizeof(fluxos[c])) {
+            semente = semente * 1103515245u + 12345u;
+            uint8_t n = (uint8_t)((semente >> 16) % 40);
+            uint8_t dados[40];
+            for (int k = 0; k < n; k++) {
+                semente = semente * 1103515245u + 12345u;
+                dados[k] = (uint8_t)(semente >> 16);
+            }
+            tamanhos[c] += montarQuadro(fluxos[c] + tamanhos[c], CHECKSUM_CRC8, dados, n);
+            if (c == 1) {
+                fluxos[c][tamanhos[c] - 1] ^= (semente >> 20) % 5 == 0 ? 0x10 : 0;  // Alguns ETX errados
+            }
+        }
+        MaquinaEstados maquina;
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, CHECKSUM_CRC8);
+        processarEmPedacos(&maquina, fluxos[c], tamanhos[c], tamanhos[c], &esperado[c]);
+    }
+
+    bool ok = true;
+    const size_t pools[] = {0, 2};
+    for (int teste = 0; teste < 2 && ok; teste++) {
+        ParserMultiCanal p;
+        ok = inicializarMultiCanal(&p, 3, pools[teste], CHECKSUM_CRC8);
+        ResultadoCanais r = {{0, 0, 0}, {0, 0, 0}};
+        size_t posicao[3] = {0, 0, 0};
+        size_t quadros = 0;
+        while (ok && (posicao[0] < tamanhos[0] || posicao[1] < tamanhos[1] || posicao[2] < tamanhos[2])) {
+            EntradaCanal lote[3];
+            size_t n = 0;
+            for (uint16_t c = 0; c < 3; c++) {
+                semente = semente * 1103515245u + 12345u;
+                size_t pedaco = 1 + (semente >> 16) % 50;
+                if (pedaco > tamanhos[c] - posicao[c]) {
+                    pedaco = tamanhos[c] - posicao[c];
+                }
+                if (pedaco) {
+                    lote[n++] = (EntradaCanal){c, fluxos[c] + posicao[c], pedaco};
+                    posicao[c] += pedaco;
+                }
+            }
+            quadros += processarLote(&p, lote, n, contarQuadroCanal, &r);
+        }
+        EntradaCanal invalida = {3, fluxos[0], tamanhos[0]};
+        ok = ok && processarLote(&p, &invalida, 1, contarQuadroCanal, &r) == 0 && p.entradasInvalidas == 1;
+        size_t total = 0;
+        for (int c = 0; c < 3 && ok; c++) {
+            total += (size_t)esperado[c].quadros;
+            if (teste == 0) {
+                ok = r.quadros[c] == esperado[c].quadros && r.soma[c] == esperado[c].soma;
+            }
+        }
+        ok = ok && quadros == p.quadros && p.quadros + p.quadrosPerdidos == total &&
+             p.quadrosRejeitados > 0 && p.segmentosLivres == p.segmentosPool && (pools[teste] == 0 || p.picoSegmentos <= pools[teste]) &&
+             (teste == 0 ? p.quadrosPerdidos == 0 : p.quadrosPerdidos > 0);
+        liberarMultiCanal(&p);
+    }
+    // Acima de 8191 canais o pool do pior caso não cabe: fica no máximo
+    ParserMultiCanal grande;
+    bool criou = inicializarMultiCanal(&grande, 65535, 0, CHECKSUM_CRC8);
+    ok = ok && criou && grande.segmentosPool == MC_QUADRO_PERDIDO - 1;
+    liberarMultiCanal(&grande);
+
+    if (ok) {
+        printf("Parser multicanal completou com sucesso.\n");
+    } else {
+        printf("Parser multicanal falhou.\n");
+        falhas++;
+    }
+}
+
+// Contexto do teste do decodificador paralelo: quadros e um resumo dos
+// dados que depende da ordem
+typedef struct {
+    size_t quadros;
+    unsigned long resumo;
+} ResultadoOrdem;
+
+static void resumirQuadro(ResultadoOrdem *r, const uint8_t *dados, size_t tamanho) {
+    r->quadros++;
+    r->resumo = r->resumo * 131 + tamanho;
+    for (size_t i = 0; i < tamanho; i++) {
+        r->resumo = r->resumo * 131 + dados[i];
+    }
+}
+
+static void resumirQuadroMaquina(const MaquinaEstados *maquina, void *contexto) {
+    resumirQuadro((ResultadoOrdem *)contexto, maquina->quadro.ptr, maquina->quadro.len);
+}
+
+static void resumirQuadroCaptura(size_t posicao, const uint8_t *dados, size_t tamanho, void *contexto) {
+    (void)posicao;
+    resumirQuadro((ResultadoOrdem *)contexto, dados, tamanho);
+}
+
+// Teste do decodificador paralelo: captura com linha ociosa, bits trocados,
+// uma longa sequência de STX e um quadro incompleto no fim; com qualquer
+// número de threads e tamanho de pedaço o resultado é o de um único
+// processarBytes sobre a captura inteira (mesmos quadros, na mesma ordem)
+void testarDecodificadorParalelo() {
+    static uint8_t captura[60000];
+    size_t total = 0, sequencia = 0;
+    unsigned semente = 11;
+    while (total + 300 < sizeof(captura)) {
+        semente = semente * 1103515245u + 12345u;
+        size_t ocioso = (semente >> 16) % 50;
+        memset(captura + total, 0xFF, ocioso);
+        total += ocioso;
+        if (sequencia == 0 && total > 30000) {
+            sequencia = total;  // Preenchida depois dos erros de bit
+            total += 6000;
+        }
+        uint8_t n = (uint8_t)((semente >> 20) % 120);
+        uint8_t dados[120];
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            dados[k] = (uint8_t)(semente >> 16);
+        }
+        total += montarQuadro(captura + total, CHECKSUM_CRC8, dados, n);
+    }
+    for (size_t i = 0; i < total * 8; i++) {
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 2000 == 0) {
+            captura[i / 8] ^= (uint8_t)(1u << (i % 8));
+        }
+    }
+    // Sem ressincronização, STX de 6 em 6 bytes; intacta, para que uma
+    // divisa dentro dela não reencontre a cadeia verdadeira
+    memset(captura + sequencia, STX, 6000);
+    captura[total++] = STX;  // Quadro incompleto
+    captura[total++] = 40;
+
+    bool ok = true;
+    bool refez = false, costurou = false;
+    for (int ressincronizar = 0; ressincronizar < 2 && ok; ressincronizar++) {
+        MaquinaEstados maquina;
+        ResultadoOrdem esperado = {0, 0};
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, CHECKSUM_CRC8);
+        configurarRessincronizacao(&maquina, ressincronizar);
+        processarBytes(&maquina, captura, total, resumirQuadroMaquina, &esperado);
+        ok = esperado.quadros > 100 && (ressincronizar == 0 || maquina.quadrosRecuperados > 0);
+
+        const unsigned threads[] = {1, 2, 3};
+        // sequencia + 1: divisa dentro da sequência de STX, fora do passo de 6
+        // da cadeia verdadeira, e a cabeça termina antes dela (refeito em série)
+        const size_t pedacos[] = {7, 300, 4096, 20000, sequencia + 1};
+        for (size_t a = 0; a < 3 && ok; a++) {
+            for (size_t b = 0; b < 5 && ok; b++) {
+                DecodificadorCaptura d;
+                ResultadoOrdem r = {0, 0};
+                inicializarDecodificador(&d, CHECKSUM_CRC8, ressincronizar, threads[a]);
+                d.tamanhoPedaco = pedacos[b];
+                ok = decodificarCaptura(&d, captura, total, resumirQuadroCaptura, &r) == esperado.quadros &&
+                     r.quadros == esperado.quadros && r.resumo == esperado.resumo &&
+                     d.bytesDescartados == maquina.bytesDescartados &&
+                     d.contagem.recuperados == maquina.quadrosRecuperados && d.bytesPendentes == 2;
+                refez = refez || d.pedacosRefeitos > 0;
+                costurou = costurou || (d.pedacos > 1 && d.pedacosRefeitos < d.pedacos);
+            }
+        }
+    }
+    ok = ok && refez && costurou;
+
+    if (ok) {
+        printf("Decodificador paralelo completou com sucesso.\n");
+    } else {
+        printf("Decodificador paralelo falhou.\n");
+        falhas++;
     }
 }
 
 int main() {
     testarMaquinaEstados();
-    return 0;
+    testarProcessarBytes();
+    testarChecksum();
+    testarVisaoQuadro();
+    testarRessincronizacao();
+    testarMultiCanal();
+    testarBuscaStx();
+    testarDecodificadorParalelo();
+    return falhas != 0;
 }
@@ -0,0 +1,265 @@
+// Máquina de estados do quadro STX | TAMANHO | DADOS | CHECKSUM | ETX (switch-case)
+//
+// Máquina byte a byte (processarByte) e em bloco (processarBytes), com
+// checksum configurável e ressincronização. Teste:
+//   gcc -g FSMswitchCase.c -o FSMswitchCase
+//   gcc -g -DCHECKSUM_SMALL FSMswitchCase.c -o FSMswitchCase-small
+//     (CRCs só com a tabela de nibbles, como no Cortex-M0+)
+
+#ifndef FSM_SWITCH_CASE_H
+#define FSM_SWITCH_CASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "frame-checksum.h"
+#include "stx-scan.h"
+
+#define STX 0x02
+#define ETX 0x03
+
+// Definição dos estados da máquina de estados
+typedef enum {
+    ESPERANDO_STX,      // Esperando pelo byte STX
+    LENDO_TAMANHO,      // Lendo o tamanho dos dados
+    LENDO_DADOS,        // Lendo os dados
+    LENDO_CHECKSUM,     // Lendo o checksum
+    ESPERANDO_ETX,      // Esperando pelo byte ETX
+    PROCESSO_COMPLETO,  // Processo concluído
+    PROCESSO_ERRO       // Erro no processamento
+} EstadoParser;
+
+// Visão dos dados de um quadro: aponta para a entrada de processarBytes
+// quando o quadro chegou inteiro na mesma chamada, ou para 'dados'
+typedef struct {
+    const uint8_t *ptr;
+    size_t len;
+} VisaoQuadro;
+
+// Estrutura da máquina de estados
+typedef struct {
+    EstadoParser estadoAtual; // Estado atual
+    uint8_t tamanho;          // Tamanho dos dados
+    uint8_t dados[256];       // Buffer para os dados (reserva em processarBytes)
+    VisaoQuadro quadro;       // Dados do último quadro (válida no AoReceberQuadro)
+    uint16_t checksum;        // Valor do checksum recebido
+    uint8_t indiceDados;      // Índice atual no buffer de dados
+    ChecksumAlgorithm algoritmo; // Verificação do quadro (frame-checksum.h)
+    uint16_t checksumCalculado;  // Cálculo incremental sobre tamanho + dados
+    uint8_t bytesChecksum;       // Bytes do checksum já lidos
+    bool ressincronizar;         // Varrer de novo os bytes de um quadro rejeitado
+    bool quadroRecuperado;       // O STX atual foi achado nessa nova varredura
+    size_t bytesDescartados;     // Bytes que não fizeram parte de quadro válido
+    size_t quadrosRecuperados;   // Quadros válidos achados dentro de quadros rejeitados
+} MaquinaEstados;
+
+// Função chamada a cada quadro completo (dados em maquina->quadro)
+typedef void (*AoReceberQuadro)(const MaquinaEstados *maquina, void *contexto);
+
+// Função para inicializar a máquina de estados
+static inline void inicializarMaquina(MaquinaEstados *maquina) {
+    maquina->estadoAtual = ESPERANDO_STX;
+    maquina->tamanho = 0;
+    maquina->checksum = 0;
+    maquina->indiceDados = 0;
+    maquina->quadro.ptr = maquina->dados;
+    maquina->quadro.len = 0;
+    maquina->algoritmo = CHECKSUM_NONE;
+    maquina->checksumCalculado = 0;
+    maquina->bytesChecksum = 0;
+    maquina->ressincronizar = false;
+    maquina->quadroRecuperado = false;
+    maquina->bytesDescartados = 0;
+    maquina->quadrosRecuperados = 0;
+}
+
+// Função para escolher o algoritmo de verificação (padrão: CHECKSUM_NONE)
+static inline void configurarChecksum(MaquinaEstados *maquina, ChecksumAlgorithm algoritmo) {
+    maquina->algoritmo = algoritmo;
+}
+
+// Função para ligar a ressincronização em processarBytes (padrão: desligada).
+// Sem ela, um quadro rejeitado (ETX errado ou checksum que não confere) é
+// descartado inteiro. Com ela, só o STX falso é descartado: os bytes
+// seguintes são varridos de novo em busca do próximo STX, e um quadro
+// válido que começava dentro do rejeitado não se perde.
+static inline void configurarRessincronizacao(MaquinaEstados *maquina, bool ligada) {
+    maquina->ressincronizar = ligada;
+}
+
+// Função para processar um byte na máquina de estados.
+// Depois de PROCESSO_COMPLETO ou PROCESSO_ERRO o byte seguinte já é
+// tratado como no ESPERANDO_STX, então a máquina segue um fluxo contínuo.
+// Um quadro com ETX errado ou checksum que não confere termina em
+// PROCESSO_ERRO.
+static inline bool processarByte(MaquinaEstados *maquina, uint8_t byte) {
+    switch (maquina->estadoAtual) {
+        case PROCESSO_COMPLETO:
+        case PROCESSO_ERRO:
+        case ESPERANDO_STX:
+            if (byte == STX) {
+                maquina->indiceDados = 0;
+                maquina->checksumCalculado = checksumInit(maquina->algoritmo);
+                maquina->quadroRecuperado = false;
+                maquina->estadoAtual = LENDO_TAMANHO;
+            } else {
+                maquina->bytesDescartados++;
+                maquina->estadoAtual = ESPERANDO_STX;
+            }
+            break;
+        case LENDO_TAMANHO:
+            maquina->tamanho = byte;
+            maquina->checksumCalculado = checksumUpdateByte(maquina->algoritmo, maquina->checksumCalculado, byte);
+            maquina->bytesChecksum = 0;
+            maquina->checksum = 0;
+            maquina->quadro.ptr = maquina->dados;
+            maquina->quadro.len = byte;
+            maquina->estadoAtual = byte ? LENDO_DADOS : LENDO_CHECKSUM;
+            break;
+        case LENDO_DADOS:
+            maquina->dados[maquina->indiceDados++] = byte;
+            maquina->checksumCalculado = checksumUpdateByte(maquina->algoritmo, maquina->checksumCalculado, byte);
+            if (maquina->indiceDados == maquina->tamanho) {
+                maquina->estadoAtual = LENDO_CHECKSUM;
+            }
+            break;
+        case LENDO_CHECKSUM:
+            // Mais significativo primeiro quando o campo tem 2 bytes
+            maquina->checksum = (uint16_t)((maquina->checksum << 8) | byte);
+            if (++maquina->bytesChecksum == checksumSize(maquina->algoritmo)) {
+                maquina->estadoAtual = ESPERANDO_ETX;
+            }
+            break;
+        case ESPERANDO_ETX:
+            if (byte == ETX && checksumMatches(maquina->algoritmo, maquina->checksumCalculado,
+                                               maquina->checksum)) {
+                maquina->quadrosRecuperados += maquina->quadroRecuperado;
+                maquina->estadoAtual = PROCESSO_COMPLETO;
+                return true;
+            } else {
+                // STX, tamanho, dados, checksum e o byte no lugar do ETX
+                maquina->bytesDescartados += (size_t)maquina->tamanho + checksumSize(maquina->algoritmo) + 3;
+                maquina->estadoAtual = PROCESSO_ERRO;
+            }
+            break;
+    }
+    return false;
+}
+
+// Varre 'buf' a partir do estado atual; os bytes antes de 'limite' já são
+// uma nova varredura (ressincronização). Usada por processarBytes.
+static inline size_t processarTrecho(MaquinaEstados *maquina, const uint8_t *buf, size_t tamanho,
+                                     AoReceberQuadro aoReceberQuadro, void *contexto, size_t limite) {
+    size_t i = 0, quadros = 0;
+    size_t inicio = SIZE_MAX;  // Posição do STX do quadro atual neste trecho
+    while (i < tamanho) {
+        switch (maquina->estadoAtual) {
+            case PROCESSO_COMPLETO:
+            case PROCESSO_ERRO:
+            case ESPERANDO_STX: {
+                const uint8_t *rejeitado = buf + limite;
+                const uint8_t *stx = stxFindFrame(buf + i, buf + tamanho, checksumSize(maquina->algoritmo),
+                                                  maquina->ressincronizar, &rejeitado);
+                limite = (size_t)(rejeitado - buf);  // Candidatos pulados contam como rejeitados
+                if (stx == NULL) {
+                    maquina->bytesDescartados += tamanho - i;
+                    maquina->estadoAtual = ESPERANDO_STX;
+                    i = tamanho;
+                    break;
+                }
+                inicio = (size_t)(stx - buf);
+                maquina->bytesDescartados += inicio - i;
+                i = inicio + 1;
+                maquina->indiceDados = 0;
+                maquina->checksumCalculado = checksumInit(maquina->algoritmo);
+                maquina->quadroRecuperado = inicio < limite;
+                maquina->estadoAtual = LENDO_TAMANHO;
+                break;
+            }
+            case LENDO_DADOS: {
+                size_t n = (size_t)(maquina->tamanho - maquina->indiceDados);
+                if (maquina->indiceDados == 0 && n <= tamanho - i) {
+                    maquina->quadro.ptr = buf + i;  // Sem cópia
+                } else {
+                    if (n > tamanho - i) {
+                        n = tamanho - i;
+                    }
+                    memcpy(&maquina->dados[maquina->indiceDados], buf + i, n);
+                }
+                maquina->checksumCalculado = checksumUpdate(maquina->algoritmo, maquina->checksumCalculado, buf + i, n);
+                maquina->indiceDados += (uint8_t)n;
+                i += n;
+                if (maquina->indiceDados == maquina->tamanho) {
+                    maquina->estadoAtual = LENDO_CHECKSUM;
+                }
+                break;
+            }
+            default:
+                if (processarByte(maquina, buf[i++])) {
+                    quadros++;
+                    if (aoReceberQuadro) {
+                        aoReceberQuadro(maquina, contexto);
+                    }
+                } else if (maquina->estadoAtual == PROCESSO_ERRO && maquina->ressincronizar) {
+                    // Só o STX falso fica descartado; o resto é varrido de novo
+                    size_t k = checksumSize(maquina->algoritmo);
+                    size_t consumidos = (size_t)maquina->tamanho + k + 2;  // Após o STX
+                    maquina->bytesDescartados -= consumidos;
+                    if (limite < i) {
+                        limite = i;
+                    }
+                    if (inicio != SIZE_MAX) {
+                        i = inicio + 1;  // Quadro inteiro neste trecho: basta voltar
+                    } else {
+                        // O quadro começou em chamada anterior: a parte que veio
+                        // antes de 'buf' é refeita a partir do estado (tamanho,
+                        // dados e checksum) e varrida antes de buf[0]
+                        uint8_t anterior[1 + 255 + 2];
+                        size_t n = consumidos - i;
+                        anterior[0] = maquina->tamanho;
+                        memcpy(&anterior[1], maquina->quadro.ptr, maquina->tamanho);
+                        for (size_t j = 0; j < k; j++) {
+                            anterior[1 + maquina->tamanho + j] = (uint8_t)(maquina->checksum >> (8 * (k - 1 - j)));
+                        }
+                        maquina->estadoAtual = ESPERANDO_STX;
+                        quadros += processarTrecho(maquina, anterior, n, aoReceberQuadro, contexto, n);
+                        i = 0;
+                    }
+                    inicio = SIZE_MAX;
+                }
+                break;
+        }
+    }
+    if (maquina->quadro.ptr != maquina->dados &&
+        (maquina->estadoAtual == LENDO_CHECKSUM || maquina->estadoAtual == ESPERANDO_ETX)) {
+        memcpy(maquina->dados, maquina->quadro.ptr, maquina->quadro.len);
+        maquina->quadro.ptr = maquina->dados;
+    }
+    return quadros;
+}
+
+// Função para processar um bloco de bytes de uma vez.
+// Fora de um quadro procura o STX com stxFindFrame (stx-scan.h: SSE2/AVX2
+// no x86), que já confere o byte na posição do ETX e pula os candidatos
+// que a máquina rejeitaria, com o mesmo resultado (quadros e contadores)
+// de passá-los pela máquina. No estado LENDO_DADOS, se
+// os dados do quadro estão inteiros no bloco, maquina->quadro passa a
+// apontar direto para eles, sem cópia; só um quadro que atravessa o fim
+// do bloco é copiado (com um único memcpy por trecho) para 'dados'. O
+// checksum é atualizado sobre o trecho inteiro. Chama aoReceberQuadro
+// (se não for NULL) a cada quadro completo e retorna quantos quadros
+// foram completados.
+// O bloco pode terminar no meio de um quadro: o estado é mantido para a
+// próxima chamada, e dados que ainda apontavam para 'buf' são copiados
+// para 'dados', pois 'buf' pode ser reutilizado por quem chama.
+// Com configurarRessincronizacao, um quadro rejeitado volta a ser varrido
+// a partir do byte seguinte ao STX falso, mesmo que tenha começado em
+// uma chamada anterior (o que veio antes é refeito a partir do estado).
+static inline size_t processarBytes(MaquinaEstados *maquina, const uint8_t *buf, size_t tamanho,
+                                    AoReceberQuadro aoReceberQuadro, void *contexto) {
+    return processarTrecho(maquina, buf, tamanho, aoReceberQuadro, contexto, 0);
+}
+
+#endif // FSM_SWITCH_CASE_H
@@ -0,0 +1,126 @@
+// Benchmark: vazão de cada algoritmo de checksum (frame-checksum.h) e do
+// processarBytes com a verificação ligada.
+//
+// Kernels: soma e XOR de 8 bits, e os CRCs bit a bit, com tabela de
+// nibbles (a do Cortex-M0+), com uma tabela de 256 entradas e com
+// slice-by-4/8. Depois mede o parser inteiro em um fluxo de quadros com
+// payload aleatório, um algoritmo por vez.
+//
+// Compilação:  gcc -O2 bench-checksum.c -o bench-checksum
+//              (só no host: mede slice-by-4/8, que não existe com
+//              CHECKSUM_SMALL nem no Cortex-M0+)
+// Uso:         ./bench-checksum [MB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FSMswitchCase.h"
+
+#define BLOCO 4096
+
+static size_t tamanho_dados;
+static uint8_t *dados;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void relatarKernel(const char *nome, double tempo, size_t bytes, unsigned verificacao) {
+    printf("%-18s %9.1f MB/s  (resultado %04x)\n", nome, bytes / tempo / 1e6, verificacao);
+}
+
+// Cada kernel processa o buffer em quadros de 255 bytes, como no parser
+#define MEDIR_KERNEL(nome, tipo, inicial, chamada)                                  \
+    do {                                                                           \
+        tipo c = (inicial);                                                        \
+        double inicio = agora();                                                   \
+        for (size_t i = 0; i + 255 <= tamanho_dados; i += 255) {                   \
+            const uint8_t *p = dados + i;                                          \
+            c = chamada;                                                           \
+        }                                                                          \
+        relatarKernel(nome, agora() - inicio, tamanho_dados / 255 * 255, c);       \
+    } while (0)
+
+static void medirKernels(size_t limiteBitwise) {
+    size_t total = tamanho_dados;
+    MEDIR_KERNEL("soma8", uint16_t, 0, checksumUpdate(CHECKSUM_SUM8, c, p, 255));
+    MEDIR_KERNEL("xor8", uint16_t, 0, checksumUpdate(CHECKSUM_XOR8, c, p, 255));
+    tamanho_dados = limiteBitwise;
+    MEDIR_KERNEL("crc8 bit a bit", uint8_t, 0, crc8Bitwise(c, p, 255));
+    tamanho_dados = total;
+    MEDIR_KERNEL("crc8 nibble", uint8_t, 0, crc8Nibbles(c, p, 255));
+    MEDIR_KERNEL("crc8 tabela", uint8_t, 0, crc8Slice(c, p, 255, 1));
+    MEDIR_KERNEL("crc8 slice-by-4", uint8_t, 0, crc8Slice(c, p, 255, 4));
+    MEDIR_KERNEL("crc8 slice-by-8", uint8_t, 0, crc8Slice(c, p, 255, 8));
+    tamanho_dados = limiteBitwise;
+    MEDIR_KERNEL("crc16 bit a bit", uint16_t, 0xFFFF, crc16Bitwise(c, p, 255));
+    tamanho_dados = total;
+    MEDIR_KERNEL("crc16 nibble", uint16_t, 0xFFFF, crc16Nibbles(c, p, 255));
+    MEDIR_KERNEL("crc16 tabela", uint16_t, 0xFFFF, crc16Slice(c, p, 255, 1));
+    MEDIR_KERNEL("crc16 slice-by-4", uint16_t, 0xFFFF, crc16Slice(c, p, 255, 4));
+    MEDIR_KERNEL("crc16 slice-by-8", uint16_t, 0xFFFF, crc16Slice(c, p, 255, 8));
+}
+
+// Fluxo de quadros de 200 bytes com o checksum do algoritmo escolhido
+static size_t montarFluxo(uint8_t *fluxo, size_t limite, ChecksumAlgorithm algoritmo) {
+    size_t i = 0, q = 0;
+    while (i + 210 < limite) {
+        uint8_t *quadro = fluxo + i;
+        quadro[0] = STX;
+        quadro[1] = 200;
+        memcpy(quadro + 2, dados + (q++ % 1000) * 200, 200);
+        size_t n = 202;
+        uint16_t c = checksumUpdate(algoritmo, checksumInit(algoritmo), quadro + 1, 201);
+        if (checksumSize(algoritmo) == 2) {
+            quadro[n++] = (uint8_t)(c >> 8);
+        }
+        quadro[n++] = (uint8_t)c;
+        quadro[n++] = ETX;
+        i += n;
+    }
+    return i;
+}
+
+static void medirParser(void) {
+    static const struct { const char *nome; ChecksumAlgorithm algoritmo; } casos[] = {
+        {"nenhum", CHECKSUM_NONE}, {"soma8", CHECKSUM_SUM8}, {"xor8", CHECKSUM_XOR8},
+        {"crc8", CHECKSUM_CRC8}, {"crc16", CHECKSUM_CRC16_CCITT},
+    };
+    uint8_t *fluxo = malloc(tamanho_dados);
+    for (size_t k = 0; k < sizeof(casos) / sizeof(casos[0]); k++) {
+        size_t n = montarFluxo(fluxo, tamanho_dados, casos[k].algoritmo);
+        MaquinaEstados maquina;
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, casos[k].algoritmo);
+        size_t quadros = 0;
+        double inicio = agora();
+        for (size_t b = 0; b < n; b += BLOCO) {
+            quadros += processarBytes(&maquina, fluxo + b, n - b < BLOCO ? n - b : BLOCO, NULL, NULL);
+        }
+        double tempo = agora() - inicio;
+        printf("processarBytes %-7s %8.1f MB/s  quadros aceitos %zu\n", casos[k].nome, n / tempo / 1e6, quadros);
+    }
+    free(fluxo);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 64;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    tamanho_dados = megabytes * 1000000;
+    dados = malloc(tamanho_dados);
+    unsigned semente = 3;
+    for (size_t i = 0; i < tamanho_dados; i++) {
+        semente = semente * 1103515245u + 12345u;
+        dados[i] = (uint8_t)(semente >> 16);
+    }
+
+    printf("dados=%zu MB\n", megabytes);
+    medirKernels(tamanho_dados / 8);
+    medirParser();
+    free(dados);
+    return 0;
+}
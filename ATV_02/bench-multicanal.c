@@ -0,0 +1,189 @@
+// Benchmark: muitos enlaces seriais em um gateway. Compara um
+// MaquinaEstados por canal (processarBytes) com o ParserMultiCanal
+// (multi-channel.h: estado em vetores + pool de buffers), com 1, 64 e 512
+// canais.
+//
+// Cada canal tem seu próprio fluxo de quadros (dados de 0 a 63 bytes, um
+// pouco de ruído entre eles). A entrada chega em rajadas de 1 a 64 bytes,
+// uma rajada por canal a cada rodada, como em uma varredura das UARTs; as
+// duas versões processam exatamente as mesmas rajadas, e o ParserMultiCanal
+// recebe a rodada inteira em uma chamada de processarLote.
+//
+// Memória por canal: sizeof(MaquinaEstados) contra os vetores do
+// ParserMultiCanal mais a parte do pool. O pool é dimensionado para o pior
+// caso (nenhum quadro perdido); "pool no pico" é quanto bastaria com o
+// maior número de segmentos em uso ao mesmo tempo (MC_SEGMENTO bytes + 4 de
+// encadeamento e pilha cada).
+//
+// Compilação:  gcc -O2 bench-multicanal.c -o bench-multicanal
+// Uso:         ./bench-multicanal [MB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FSMswitchCase.h"
+#include "multi-channel.h"
+
+#define REPETICOES 3
+
+static uint8_t *fluxo;             // Fluxos dos canais, um após o outro
+static size_t tamanho_fluxo;
+static size_t quadros_gerados;
+static EntradaCanal *rajadas;
+static size_t numero_rajadas;
+static unsigned semente = 7;
+
+static unsigned sortear(void) {
+    semente = semente * 1103515245u + 12345u;
+    return semente >> 16;
+}
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Gera 'megabytes' de quadros divididos entre os canais e a ordem das
+// rajadas (rodadas de uma rajada por canal)
+static void gerarEntrada(size_t megabytes, size_t canais) {
+    size_t porCanal = megabytes * 1000000 / canais;
+    fluxo = malloc(canais * (porCanal + 80));
+    size_t *inicio = malloc((canais + 1) * sizeof(size_t));
+    size_t i = 0;
+    quadros_gerados = 0;
+    for (size_t c = 0; c < canais; c++) {
+        inicio[c] = i;
+        size_t limite = i + porCanal;
+        while (i < limite) {
+            size_t ruido = sortear() % 3;
+            for (size_t k = 0; k < ruido; k++) {
+                fluxo[i++] = 0x55;
+            }
+            uint8_t n = (uint8_t)(sortear() % 64);
+            fluxo[i++] = STX;
+            fluxo[i++] = n;
+            for (int k = 0; k < n; k++) {
+                fluxo[i++] = (uint8_t)sortear();
+            }
+            fluxo[i++] = 0;
+            fluxo[i++] = ETX;
+            quadros_gerados++;
+        }
+    }
+    inicio[canais] = i;
+    tamanho_fluxo = i;
+
+    size_t capacidade = tamanho_fluxo / 16 + canais;
+    rajadas = malloc(capacidade * sizeof(EntradaCanal));
+    numero_rajadas = 0;
+    size_t *posicao = malloc(canais * sizeof(size_t));
+    for (size_t c = 0; c < canais; c++) {
+        posicao[c] = inicio[c];
+    }
+    size_t restantes = canais;
+    while (restantes) {
+        restantes = 0;
+        for (size_t c = 0; c < canais; c++) {
+            size_t fim = inicio[c + 1];
+            if (posicao[c] == fim) {
+                continue;
+            }
+            size_t n = 1 + sortear() % 64;
+            if (n > fim - posicao[c]) {
+                n = fim - posicao[c];
+            }
+            if (numero_rajadas == capacidade) {
+                capacidade *= 2;
+                rajadas = realloc(rajadas, capacidade * sizeof(EntradaCanal));
+            }
+            rajadas[numero_rajadas++] = (EntradaCanal){(uint16_t)c, fluxo + posicao[c], n};
+            posicao[c] += n;
+            restantes += posicao[c] < fim;
+        }
+    }
+    free(posicao);
+    free(inicio);
+}
+
+static void somarQuadro(const MaquinaEstados *maquina, void *contexto) {
+    *(unsigned long *)contexto += maquina->quadro.len + (maquina->quadro.len ? maquina->quadro.ptr[0] : 0);
+}
+
+static void somarQuadroCanal(uint16_t canal, const uint8_t *dados, size_t tamanho, void *contexto) {
+    (void)canal;
+    *(unsigned long *)contexto += tamanho + (tamanho ? dados[0] : 0);
+}
+
+static void relatar(const char *nome, double tempo, size_t quadros, unsigned long verificacao,
+                    double bytesCanal) {
+    printf("  %-14s %7.2f Mquadros/s  %7.1f MB/s  %7.1f B/canal  quadros %zu/%zu  verificação %lu\n",
+           nome, quadros / tempo / 1e6, tamanho_fluxo / tempo / 1e6, bytesCanal, quadros,
+           quadros_gerados, verificacao);
+}
+
+static void medir(size_t megabytes, size_t canais) {
+    gerarEntrada(megabytes, canais);
+    printf("canais=%zu fluxo=%zu bytes quadros=%zu rajadas=%zu\n", canais, tamanho_fluxo, quadros_gerados,
+           numero_rajadas);
+
+    double melhor = 1e30;
+    size_t quadros = 0;
+    unsigned long verificacao = 0;
+    for (int r = 0; r < REPETICOES; r++) {
+        MaquinaEstados *maquinas = malloc(canais * sizeof(MaquinaEstados));
+        for (size_t c = 0; c < canais; c++) {
+            inicializarMaquina(&maquinas[c]);
+        }
+        quadros = 0;
+        verificacao = 0;
+        double inicio = agora();
+        for (size_t e = 0; e < numero_rajadas; e++) {
+            quadros += processarBytes(&maquinas[rajadas[e].canal], rajadas[e].dados, rajadas[e].tamanho,
+                                      somarQuadro, &verificacao);
+        }
+        double tempo = agora() - inicio;
+        if (tempo < melhor) melhor = tempo;
+        free(maquinas);
+    }
+    relatar("MaquinaEstados", melhor, quadros, verificacao, (double)sizeof(MaquinaEstados));
+
+    melhor = 1e30;
+    size_t pico = 0;
+    for (int r = 0; r < REPETICOES; r++) {
+        ParserMultiCanal p;
+        if (!inicializarMultiCanal(&p, canais, 0, CHECKSUM_NONE)) {
+            fprintf(stderr, "sem memória\n");
+            exit(1);
+        }
+        quadros = 0;
+        verificacao = 0;
+        double inicio = agora();
+        for (size_t e = 0; e < numero_rajadas; e += canais) {
+            size_t n = numero_rajadas - e < canais ? numero_rajadas - e : canais;
+            quadros += processarLote(&p, rajadas + e, n, somarQuadroCanal, &verificacao);
+        }
+        double tempo = agora() - inicio;
+        if (tempo < melhor) melhor = tempo;
+        pico = p.picoSegmentos;
+        liberarMultiCanal(&p);
+    }
+    double porSegmento = MC_SEGMENTO + 2 * sizeof(uint16_t);
+    relatar("MultiCanal", melhor, quadros, verificacao, bytesPorCanal() + porSegmento * MC_SEGMENTOS_POR_QUADRO);
+    printf("  %-14s segmentos em uso no pico: %zu de %zu  ->  %.1f B/canal\n", "pool no pico", pico,
+           canais * MC_SEGMENTOS_POR_QUADRO, bytesPorCanal() + porSegmento * pico / canais);
+
+    free(rajadas);
+    free(fluxo);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 32;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    const size_t canais[] = {1, 64, 512};
+    for (size_t k = 0; k < sizeof(canais) / sizeof(canais[0]); k++) {
+        medir(megabytes, canais[k]);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Benchmark: processarByte (um byte por chamada) contra processarBytes
+// (memchr até o STX + visão sem cópia dos dados) em um fluxo sintético
+// grande.
+//
+// O fluxo tem quadros com tamanho de dados aleatório (0 a 255) e, entre
+// eles, um pouco de ruído sem STX. É entregue em blocos de BLOCO bytes,
+// como chegaria de uma leitura de UART/socket.
+//
+// Compilação:  gcc -O2 bench-parse.c -o bench-parse
+// Uso:         ./bench-parse [MB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FSMswitchCase.h"
+
+#define BLOCO 4096
+
+static uint8_t *fluxo;
+static size_t tamanho_fluxo;
+static size_t quadros_gerados;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void gerarFluxo(size_t megabytes) {
+    size_t limite = megabytes * 1000000;
+    fluxo = malloc(limite + 512);
+    unsigned semente = 7;
+    size_t i = 0;
+    while (i < limite) {
+        semente = semente * 1103515245u + 12345u;
+        size_t ruido = (semente >> 16) % 4;
+        for (size_t k = 0; k < ruido; k++) {
+            fluxo[i++] = 0x55;
+        }
+        semente = semente * 1103515245u + 12345u;
+        uint8_t n = (uint8_t)(semente >> 16);
+        fluxo[i++] = STX;
+        fluxo[i++] = n;
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            fluxo[i++] = (uint8_t)(semente >> 16);
+        }
+        fluxo[i++] = 0;
+        fluxo[i++] = ETX;
+        quadros_gerados++;
+    }
+    tamanho_fluxo = i;
+}
+
+static void somarQuadro(const MaquinaEstados *maquina, void *contexto) {
+    *(unsigned long *)contexto += maquina->quadro.len + (maquina->quadro.len ? maquina->quadro.ptr[0] : 0);
+}
+
+static void relatar(const char *nome, double tempo, size_t quadros, unsigned long verificacao) {
+    printf("%-14s %8.1f MB/s  quadros %zu/%zu  verificação %lu\n", nome,
+           tamanho_fluxo / tempo / 1e6, quadros, quadros_gerados, verificacao);
+}
+
+static void medirPorByte(void) {
+    MaquinaEstados maquina;
+    inicializarMaquina(&maquina);
+    size_t quadros = 0;
+    unsigned long verificacao = 0;
+    double inicio = agora();
+    for (size_t b = 0; b < tamanho_fluxo; b += BLOCO) {
+        size_t fim = b + BLOCO < tamanho_fluxo ? b + BLOCO : tamanho_fluxo;
+        for (size_t i = b; i < fim; i++) {
+            if (processarByte(&maquina, fluxo[i])) {
+                quadros++;
+                somarQuadro(&maquina, &verificacao);
+            }
+        }
+    }
+    relatar("processarByte", agora() - inicio, quadros, verificacao);
+}
+
+static void medirBloco(void) {
+    MaquinaEstados maquina;
+    inicializarMaquina(&maquina);
+    size_t quadros = 0;
+    unsigned long verificacao = 0;
+    double inicio = agora();
+    for (size_t b = 0; b < tamanho_fluxo; b += BLOCO) {
+        size_t n = b + BLOCO < tamanho_fluxo ? BLOCO : tamanho_fluxo - b;
+        quadros += processarBytes(&maquina, fluxo + b, n, somarQuadro, &verificacao);
+    }
+    relatar("processarBytes", agora() - inicio, quadros, verificacao);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 256;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    gerarFluxo(megabytes);
+    printf("fluxo=%zu bytes quadros=%zu bloco=%d\n", tamanho_fluxo, quadros_gerados, BLOCO);
+    medirPorByte();
+    medirBloco();
+    free(fluxo);
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Benchmark: busca do STX em uma captura com muita linha ociosa.
+//
+// O fluxo imita uma captura de linha serial: longos trechos de
+// preenchimento ocioso (0xFF), quadros com CRC-8 (dados de 0 a 63 bytes)
+// e, de vez em quando, um 0x02 solto no meio do trecho ocioso (um STX
+// falso, como o de um ruído na linha).
+//
+// Primeiro só a busca, contando os STX do fluxo com cada implementação:
+//   byte a byte   laço comparando um byte por vez
+//   memchr        libc
+//   escalar       stxFindScalar (palavra de 32 bits por vez)
+//   SSE2, AVX2    stxFindSse2 / stxFindAvx2 (se compiladas)
+// Depois o parser inteiro:
+//   processarByte    um byte por chamada
+//   processarBytes   busca com stxFindFrame (stx-scan.h) em blocos de BLOCO
+//   + ressinc.       o mesmo com configurarRessincronizacao: os STX falsos
+//                    deixam de engolir os quadros seguintes
+//
+// Compilação:  gcc -O2 bench-stx.c -o bench-stx
+//              gcc -O2 -mavx2 bench-stx.c -o bench-stx   (inclui AVX2)
+// Uso:         ./bench-stx [MB] [ocioso%]   (padrão: 64 MB, 95% ocioso)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FSMswitchCase.h"
+
+#define BLOCO 4096
+#define REPETICOES 3
+
+static uint8_t *fluxo;
+static size_t tamanho_fluxo;
+static size_t quadros_gerados;
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Gera o fluxo com 'ocioso' por cento dos bytes em preenchimento
+static void gerarFluxo(size_t megabytes, unsigned ocioso) {
+    size_t limite = megabytes * 1000000;
+    fluxo = malloc(limite + 512);
+    unsigned semente = 7;
+    size_t i = 0;
+    while (i < limite) {
+        semente = semente * 1103515245u + 12345u;
+        uint8_t n = (uint8_t)((semente >> 16) % 64);
+        // Quadro médio de n + 4 bytes; o trecho ocioso antes dele é sorteado
+        // em torno do tamanho que dá a proporção pedida
+        size_t media = ocioso >= 100 ? limite : (size_t)(n + 4) * ocioso / (100 - ocioso);
+        semente = semente * 1103515245u + 12345u;
+        size_t trecho = media ? (semente >> 8) % (2 * media + 1) : 0;
+        if (trecho > limite - i) {
+            trecho = limite - i;
+        }
+        memset(fluxo + i, 0xFF, trecho);
+        semente = semente * 1103515245u + 12345u;
+        if (trecho > 0 && (semente >> 16) % 4 == 0) {
+            fluxo[i + (semente >> 4) % trecho] = STX;  // STX falso no trecho ocioso
+        }
+        i += trecho;
+        if (i == limite) {
+            break;
+        }
+        size_t inicio = i;
+        fluxo[i++] = STX;
+        fluxo[i++] = n;
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            fluxo[i++] = (uint8_t)(semente >> 16);
+        }
+        fluxo[i++] = (uint8_t)checksumUpdate(CHECKSUM_CRC8, 0, &fluxo[inicio + 1], (size_t)n + 1);
+        fluxo[i++] = ETX;
+        quadros_gerados++;
+    }
+    tamanho_fluxo = i;
+}
+
+// ---- Só a busca ----
+
+typedef const uint8_t *(*Busca)(const uint8_t *p, const uint8_t *fim);
+
+static const uint8_t *buscarByteAByte(const uint8_t *p, const uint8_t *fim) {
+    for (; p < fim; p++) {
+        if (*p == STX) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static const uint8_t *buscarMemchr(const uint8_t *p, const uint8_t *fim) {
+    return (const uint8_t *)memchr(p, STX, (size_t)(fim - p));
+}
+
+static void medirBusca(const char *nome, Busca buscar) {
+    double melhor = 1e30;
+    size_t encontrados = 0;
+    for (int r = 0; r < REPETICOES; r++) {
+        encontrados = 0;
+        double inicio = agora();
+        const uint8_t *p = fluxo, *fim = fluxo + tamanho_fluxo;
+        while ((p = buscar(p, fim)) != NULL) {
+            encontrados++;
+            p++;
+        }
+        double tempo = agora() - inicio;
+        if (tempo < melhor) melhor = tempo;
+    }
+    printf("  %-15s %8.1f MB/s  %6.3f ns/byte  STX %zu\n", nome, tamanho_fluxo / melhor / 1e6,
+           melhor * 1e9 / tamanho_fluxo, encontrados);
+}
+
+// ---- Parser inteiro ----
+
+static void somarQuadro(const MaquinaEstados *maquina, void *contexto) {
+    *(unsigned long *)contexto += maquina->quadro.len + (maquina->quadro.len ? maquina->quadro.ptr[0] : 0);
+}
+
+// Melhor de REPETICOES; 'bloco' = 0 usa processarByte, um byte por chamada
+static void medirParser(const char *nome, size_t bloco, bool ressincronizar) {
+    double melhor = 1e30;
+    size_t quadros = 0, descartados = 0;
+    unsigned long verificacao = 0;
+    for (int r = 0; r < REPETICOES; r++) {
+        MaquinaEstados maquina;
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, CHECKSUM_CRC8);
+        configurarRessincronizacao(&maquina, ressincronizar);
+        quadros = 0;
+        verificacao = 0;
+        double inicio = agora();
+        if (bloco == 0) {
+            for (size_t i = 0; i < tamanho_fluxo; i++) {
+                quadros += processarByte(&maquina, fluxo[i]);
+            }
+        } else {
+            for (size_t b = 0; b < tamanho_fluxo; b += bloco) {
+                size_t n = b + bloco < tamanho_fluxo ? bloco : tamanho_fluxo - b;
+                quadros += processarBytes(&maquina, fluxo + b, n, somarQuadro, &verificacao);
+            }
+        }
+        double tempo = agora() - inicio;
+        if (tempo < melhor) melhor = tempo;
+        descartados = maquina.bytesDescartados;
+    }
+    printf("  %-15s %8.1f MB/s  %6.3f ns/byte  quadros %zu/%zu  descartados %zu\n", nome,
+           tamanho_fluxo / melhor / 1e6, melhor * 1e9 / tamanho_fluxo, quadros, quadros_gerados, descartados);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 64;
+    unsigned ocioso = 95;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    if (argc > 2) ocioso = (unsigned)atoi(argv[2]);
+    gerarFluxo(megabytes, ocioso);
+    printf("fluxo=%zu bytes quadros=%zu ocioso=%u%% bloco=%d stxFind=%s\n", tamanho_fluxo, quadros_gerados,
+           ocioso, BLOCO, STX_SCAN_NAME);
+
+    printf("busca do STX:\n");
+    medirBusca("byte a byte", buscarByteAByte);
+    medirBusca("memchr", buscarMemchr);
+    medirBusca("escalar", stxFindScalar);
+#if defined(__SSE2__) && !defined(STX_SCAN_SCALAR)
+    medirBusca("SSE2", stxFindSse2);
+#endif
+#if defined(__AVX2__) && !defined(STX_SCAN_SCALAR)
+    medirBusca("AVX2", stxFindAvx2);
+#endif
+
+    printf("parser:\n");
+    medirParser("processarByte", 0, false);
+    medirParser("processarBytes", BLOCO, false);
+    medirParser("  + ressinc.", BLOCO, true);
+
+    free(fluxo);
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Decodificação offline de uma captura de linha serial gravada em arquivo,
+// com decodificarCaptura (parallel-decoder.h) sobre o arquivo mapeado.
+//
+// Opções:
+//   -t threads   padrão: número de processadores
+//   -c alg       none, sum8, xor8, crc8 ou crc16 (padrão: none)
+//   -r           ressincronização depois de quadros rejeitados
+//   -b MB        tamanho do pedaço (padrão: automático)
+//   -o arquivo   grava os dados de cada quadro válido, em ordem, como
+//                [LEN][dados]
+//   -v           confere o resultado com um único processarBytes sobre a
+//                captura inteira (mesmos quadros, ordem e descartados)
+//   -g MB        antes, gera no arquivo uma captura sintética desse
+//                tamanho (linha ociosa, quadros de 0 a 119 bytes com o
+//                checksum de -c e alguns erros de bit)
+//
+// Compilação:  gcc -O2 -pthread decode-capture.c -o decode-capture
+// Uso:         ./decode-capture [-t n] [-c alg] [-r] [-b MB] [-o saída] [-v] [-g MB] captura
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FSMswitchCase.h"
+#include "parallel-decoder.h"
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool lerAlgoritmo(const char *nome, ChecksumAlgorithm *alg) {
+    static const struct {
+        const char *nome;
+        ChecksumAlgorithm alg;
+    } nomes[] = {{"none", CHECKSUM_NONE}, {"sum8", CHECKSUM_SUM8}, {"xor8", CHECKSUM_XOR8},
+                 {"crc8", CHECKSUM_CRC8}, {"crc16", CHECKSUM_CRC16_CCITT}};
+    for (size_t k = 0; k < sizeof(nomes) / sizeof(nomes[0]); k++) {
+        if (strcmp(nome, nomes[k].nome) == 0) {
+            *alg = nomes[k].alg;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Gera 'megabytes' de captura sintética em 'caminho'
+static bool gerarCaptura(const char *caminho, size_t megabytes, ChecksumAlgorithm alg) {
+    FILE *f = fopen(caminho, "wb");
+    if (f == NULL) {
+        return false;
+    }
+    size_t limite = megabytes * 1000000;
+    uint8_t quadro[QUADRO_MAXIMO + 64];
+    unsigned semente = 7;
+    size_t total = 0;
+    while (total < limite) {
+        semente = semente * 1103515245u + 12345u;
+        size_t ocioso = (semente >> 16) % 64;
+        uint8_t n = (uint8_t)((semente >> 8) % 120);
+        size_t i = 0;
+        memset(quadro, 0xFF, ocioso);
+        i += ocioso;
+        size_t inicio = i;
+        quadro[i++] = STX;
+        quadro[i++] = n;
+        for (int k = 0; k < n; k++) {
+            semente = semente * 1103515245u + 12345u;
+            quadro[i++] = (uint8_t)(semente >> 16);
+        }
+        uint16_t c = checksumUpdate(alg, checksumInit(alg), &quadro[inicio + 1], (size_t)n + 1);
+        if (checksumSize(alg) == 2) {
+            quadro[i++] = (uint8_t)(c >> 8);
+        }
+        quadro[i++] = (uint8_t)c;
+        quadro[i++] = ETX;
+        // Um erro de bit a cada ~64 quadros
+        semente = semente * 1103515245u + 12345u;
+        if ((semente >> 16) % 64 == 0) {
+            quadro[(semente >> 4) % i] ^= (uint8_t)(1u << (semente % 8));
+        }
+        if (fwrite(quadro, 1, i, f) != i) {
+            fclose(f);
+            return false;
+        }
+        total += i;
+    }
+    return fclose(f) == 0;
+}
+
+// ---- Saída e verificação ----
+
+typedef struct {
+    FILE *saida;
+    size_t quadros;
+    uint64_t resumo;    // Hash dos quadros em ordem
+} Coleta;
+
+static uint64_t resumir(uint64_t h, const uint8_t *dados, size_t tamanho) {
+    h = (h ^ tamanho) * 0x100000001B3ull;
+    for (size_t k = 0; k < tamanho; k++) {
+        h = (h ^ dados[k]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static void coletarQuadro(size_t posicao, const uint8_t *dados, size_t tamanho, void *contexto) {
+    (void)posicao;
+    Coleta *c = contexto;
+    c->quadros++;
+    c->resumo = resumir(c->resumo, dados, tamanho);
+    if (c->saida != NULL) {
+        uint8_t len = (uint8_t)tamanho;
+        fwrite(&len, 1, 1, c->saida);
+        fwrite(dados, 1, tamanho, c->saida);
+    }
+}
+
+static void coletarQuadroMaquina(const MaquinaEstados *maquina, void *contexto) {
+    Coleta *c = contexto;
+    c->quadros++;
+    c->resumo = resumir(c->resumo, maquina->quadro.ptr, maquina->quadro.len);
+}
+
+static void usar(const char *programa) {
+    fprintf(stderr, "uso: %s [-t threads] [-c none|sum8|xor8|crc8|crc16] [-r] [-b MB] [-o saída] [-v] [-g MB] captura\n",
+            programa);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned threads = processadores > 0 ? (unsigned)processadores : 1;
+    ChecksumAlgorithm alg = CHECKSUM_NONE;
+    bool ressincronizar = false, verificar = false;
+    size_t pedaco = 0, gerar = 0;
+    const char *caminhoSaida = NULL;
+    int opcao;
+    while ((opcao = getopt(argc, argv, "t:c:rb:o:vg:")) != -1) {
+        switch (opcao) {
+            case 't':
+                threads = (unsigned)atoi(optarg);
+                if (threads == 0) usar(argv[0]);
+                break;
+            case 'c':
+                if (!lerAlgoritmo(optarg, &alg)) usar(argv[0]);
+                break;
+            case 'r':
+                ressincronizar = true;
+                break;
+            case 'b':
+                pedaco = (size_t)(atof(optarg) * 1e6);
+                break;
+            case 'o':
+                caminhoSaida = optarg;
+                break;
+            case 'v':
+                verificar = true;
+                break;
+            case 'g':
+                gerar = (size_t)atol(optarg);
+                break;
+            default:
+                usar(argv[0]);
+        }
+    }
+    if (optind != argc - 1) {
+        usar(argv[0]);
+    }
+    const char *caminho = argv[optind];
+
+    if (gerar > 0 && !gerarCaptura(caminho, gerar, alg)) {
+        perror(caminho);
+        return 1;
+    }
+
+    int fd = open(caminho, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(caminho);
+        return 1;
+    }
+    size_t tamanho = (size_t)st.st_size;
+    const uint8_t *captura = NULL;
+    if (tamanho > 0) {
+        captura = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (captura == MAP_FAILED) {
+            perror("mmap");
+            return 1;
+        }
+        madvise((void *)captura, tamanho, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    Coleta coleta = {NULL, 0, 0};
+    if (caminhoSaida != NULL && (coleta.saida = fopen(caminhoSaida, "wb")) == NULL) {
+        perror(caminhoSaida);
+        return 1;
+    }
+
+    DecodificadorCaptura d;
+    inicializarDecodificador(&d, alg, ressincronizar, threads);
+    d.tamanhoPedaco = pedaco;
+    double inicio = agora();
+    decodificarCaptura(&d, captura, tamanho, coletarQuadro, &coleta);
+    double tempo = agora() - inicio;
+    if (coleta.saida != NULL && fclose(coleta.saida) != 0) {
+        perror(caminhoSaida);
+        return 1;
+    }
+
+    printf("captura      %zu bytes, %u threads, pedaços %zu (refeitos %zu)\n", tamanho, threads, d.pedacos,
+           d.pedacosRefeitos);
+    printf("quadros      %zu (%zu bytes)\n", d.contagem.quadros, d.contagem.bytesQuadros);
+    printf("rejeitados   ETX %zu, checksum %zu\n", d.contagem.etxErrado, d.contagem.checksumErrado);
+    printf("recuperados  %zu\n", d.contagem.recuperados);
+    printf("descartados  %zu bytes, pendentes %zu\n", d.bytesDescartados, d.bytesPendentes);
+    printf("tempo        %.3f s  %.1f MB/s\n", tempo, tempo > 0 ? tamanho / tempo / 1e6 : 0.0);
+
+    int status = 0;
+    if (verificar) {
+        MaquinaEstados maquina;
+        Coleta esperado = {NULL, 0, 0};
+        inicializarMaquina(&maquina);
+        configurarChecksum(&maquina, alg);
+        configurarRessincronizacao(&maquina, ressincronizar);
+        inicio = agora();
+        if (tamanho > 0) {
+            processarBytes(&maquina, captura, tamanho, coletarQuadroMaquina, &esperado);
+        }
+        tempo = agora() - inicio;
+        bool igual = esperado.quadros == coleta.quadros && esperado.resumo == coleta.resumo &&
+                     maquina.bytesDescartados == d.bytesDescartados &&
+                     maquina.quadrosRecuperados == d.contagem.recuperados;
+        printf("verificação  %s (processarBytes: %zu quadros, %zu descartados, %.1f MB/s)\n",
+               igual ? "ok" : "DIFERENTE", esperado.quadros, maquina.bytesDescartados,
+               tempo > 0 ? tamanho / tempo / 1e6 : 0.0);
+        status = igual ? 0 : 1;
+    }
+
+    if (tamanho > 0) {
+        munmap((void *)captura, tamanho);
+    }
+    return status;
+}
@@ -0,0 +1,242 @@
+// Verificação de integridade dos quadros STX | TAMANHO | DADOS | CHECKSUM | ETX,
+// compartilhada pelas máquinas de estados da ATV_02 e da ATV_03.
+//
+// O campo de checksum cobre o byte de tamanho e os dados e é calculado
+// de forma incremental, à medida que os bytes chegam. Algoritmos:
+//
+//   CHECKSUM_NONE          1 byte lido e ignorado (comportamento antigo)
+//   CHECKSUM_SUM8          soma de 8 bits
+//   CHECKSUM_XOR8          XOR de 8 bits
+//   CHECKSUM_CRC8          CRC-8 (polinômio 0x07, início 0x00)
+//   CHECKSUM_CRC16_CCITT   CRC-16/CCITT-FALSE (0x1021, início 0xFFFF),
+//                          2 bytes no quadro, mais significativo primeiro
+//
+// Os CRCs têm três implementações:
+//   - slice-by-4 e slice-by-8: tabelas de 256 entradas por byte da fatia
+//     (CRC-16: 8 x 512 bytes), geradas na primeira chamada (uma só vez,
+//     mesmo com várias threads); é o padrão no host;
+//   - nibble: tabela de 16 entradas, 4 bits por consulta; é o padrão no
+//     Cortex-M0+ (__ARM_ARCH_6M__) ou com -DCHECKSUM_SMALL, e nesse caso
+//     as tabelas grandes nem são compiladas.
+// crc8Bitwise/crc16Bitwise são a referência bit a bit usada nos testes.
+
+#ifndef FRAME_CHECKSUM_H
+#define FRAME_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_6M__) && !defined(CHECKSUM_SMALL)
+#define CHECKSUM_SMALL
+#endif
+
+#ifndef CHECKSUM_SMALL
+#include <stdatomic.h>
+#endif
+
+#define CRC8_POLY  0x07
+#define CRC16_POLY 0x1021
+
+// Algoritmo de verificação do quadro
+typedef enum {
+    CHECKSUM_NONE = 0,
+    CHECKSUM_SUM8,
+    CHECKSUM_XOR8,
+    CHECKSUM_CRC8,
+    CHECKSUM_CRC16_CCITT
+} ChecksumAlgorithm;
+
+// Bytes do campo de checksum no quadro
+static inline unsigned checksumSize(ChecksumAlgorithm alg) {
+    return alg == CHECKSUM_CRC16_CCITT ? 2 : 1;
+}
+
+// Valor inicial do cálculo
+static inline uint16_t checksumInit(ChecksumAlgorithm alg) {
+    return alg == CHECKSUM_CRC16_CCITT ? 0xFFFF : 0;
+}
+
+// ---- Referência bit a bit ----
+
+static inline uint8_t crc8Bitwise(uint8_t crc, const uint8_t *p, size_t n) {
+    while (n--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) {
+            crc = (uint8_t)(crc & 0x80 ? (crc << 1) ^ CRC8_POLY : crc << 1);
+        }
+    }
+    return crc;
+}
+
+static inline uint16_t crc16Bitwise(uint16_t crc, const uint8_t *p, size_t n) {
+    while (n--) {
+        crc ^= (uint16_t)(*p++ << 8);
+        for (int b = 0; b < 8; b++) {
+            crc = (uint16_t)(crc & 0x8000 ? (crc << 1) ^ CRC16_POLY : crc << 1);
+        }
+    }
+    return crc;
+}
+
+// ---- Tabela de nibbles (16 entradas) ----
+
+static const uint8_t crc8Nibble[16] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+    0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D
+};
+
+static const uint16_t crc16Nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static inline uint8_t crc8Nibbles(uint8_t crc, const uint8_t *p, size_t n) {
+    while (n--) {
+        crc ^= *p++;
+        crc = (uint8_t)((crc << 4) ^ crc8Nibble[crc >> 4]);
+        crc = (uint8_t)((crc << 4) ^ crc8Nibble[crc >> 4]);
+    }
+    return crc;
+}
+
+static inline uint16_t crc16Nibbles(uint16_t crc, const uint8_t *p, size_t n) {
+    while (n--) {
+        crc ^= (uint16_t)(*p++ << 8);
+        crc = (uint16_t)((crc << 4) ^ crc16Nibble[crc >> 12]);
+        crc = (uint16_t)((crc << 4) ^ crc16Nibble[crc >> 12]);
+    }
+    return crc;
+}
+
+#ifndef CHECKSUM_SMALL
+
+// ---- Slice-by-4/8 (host) ----
+//
+// crcTabela[k][v] é o CRC do byte v seguido de k bytes zero. Assim uma
+// fatia de 8 bytes vira 8 consultas independentes combinadas com XOR, em
+// vez de 8 consultas encadeadas. 'fatia' = 8, 4 ou 1 (uma tabela, byte a
+// byte; usada como referência no benchmark).
+
+static uint8_t crc8Table[8][256];
+static uint16_t crc16Table[8][256];
+static atomic_int crcTablesReady;  // 0: não geradas, 1: gerando, 2: prontas
+
+static inline void crcBuildTables(void) {
+    for (int v = 0; v < 256; v++) {
+        uint8_t b = (uint8_t)v;
+        crc8Table[0][v] = crc8Bitwise(0, &b, 1);
+        crc16Table[0][v] = crc16Bitwise(0, &b, 1);
+    }
+    for (int k = 1; k < 8; k++) {
+        for (int v = 0; v < 256; v++) {
+            crc8Table[k][v] = crc8Table[0][crc8Table[k - 1][v]];
+            uint16_t c = crc16Table[k - 1][v];
+            crc16Table[k][v] = (uint16_t)((c << 8) ^ crc16Table[0][c >> 8]);
+        }
+    }
+}
+
+// Gera as tabelas na primeira chamada. Só uma thread gera; as outras
+// esperam o estado 2, cujo release publica as tabelas.
+static inline void crcTablesEnsure(void) {
+    if (atomic_load_explicit(&crcTablesReady, memory_order_acquire) == 2) {
+        return;
+    }
+    int esperado = 0;
+    if (atomic_compare_exchange_strong_explicit(&crcTablesReady, &esperado, 1, memory_order_acquire,
+                                                memory_order_acquire)) {
+        crcBuildTables();
+        atomic_store_explicit(&crcTablesReady, 2, memory_order_release);
+        return;
+    }
+    while (atomic_load_explicit(&crcTablesReady, memory_order_acquire) != 2) {
+    }
+}
+
+static inline uint8_t crc8Slice(uint8_t crc, const uint8_t *p, size_t n, int fatia) {
+    crcTablesEnsure();
+    if (fatia == 8) {
+        for (; n >= 8; n -= 8, p += 8) {
+            crc = crc8Table[7][crc ^ p[0]] ^ crc8Table[6][p[1]] ^ crc8Table[5][p[2]] ^
+                  crc8Table[4][p[3]] ^ crc8Table[3][p[4]] ^ crc8Table[2][p[5]] ^
+                  crc8Table[1][p[6]] ^ crc8Table[0][p[7]];
+        }
+    }
+    for (; fatia >= 4 && n >= 4; n -= 4, p += 4) {
+        crc = crc8Table[3][crc ^ p[0]] ^ crc8Table[2][p[1]] ^ crc8Table[1][p[2]] ^ crc8Table[0][p[3]];
+    }
+    while (n--) {
+        crc = crc8Table[0][crc ^ *p++];
+    }
+    return crc;
+}
+
+static inline uint16_t crc16Slice(uint16_t crc, const uint8_t *p, size_t n, int fatia) {
+    crcTablesEnsure();
+    if (fatia == 8) {
+        for (; n >= 8; n -= 8, p += 8) {
+            crc = crc16Table[7][(crc >> 8) ^ p[0]] ^ crc16Table[6][(crc & 0xFF) ^ p[1]] ^
+                  crc16Table[5][p[2]] ^ crc16Table[4][p[3]] ^ crc16Table[3][p[4]] ^
+                  crc16Table[2][p[5]] ^ crc16Table[1][p[6]] ^ crc16Table[0][p[7]];
+        }
+    }
+    for (; fatia >= 4 && n >= 4; n -= 4, p += 4) {
+        crc = crc16Table[3][(crc >> 8) ^ p[0]] ^ crc16Table[2][(crc & 0xFF) ^ p[1]] ^
+              crc16Table[1][p[2]] ^ crc16Table[0][p[3]];
+    }
+    while (n--) {
+        crc = (uint16_t)((crc << 8) ^ crc16Table[0][(crc >> 8) ^ *p++]);
+    }
+    return crc;
+}
+
+#endif // CHECKSUM_SMALL
+
+// Atualização incremental com n bytes
+static inline uint16_t checksumUpdate(ChecksumAlgorithm alg, uint16_t estado, const uint8_t *p, size_t n) {
+    switch (alg) {
+        case CHECKSUM_SUM8: {
+            uint8_t s = (uint8_t)estado;
+            while (n--) s += *p++;
+            return s;
+        }
+        case CHECKSUM_XOR8: {
+            uint8_t x = (uint8_t)estado;
+            while (n--) x ^= *p++;
+            return x;
+        }
+#ifdef CHECKSUM_SMALL
+        case CHECKSUM_CRC8:
+            return crc8Nibbles((uint8_t)estado, p, n);
+        case CHECKSUM_CRC16_CCITT:
+            return crc16Nibbles(estado, p, n);
+#else
+        case CHECKSUM_CRC8:
+            return crc8Slice((uint8_t)estado, p, n, 8);
+        case CHECKSUM_CRC16_CCITT:
+            return crc16Slice(estado, p, n, 8);
+#endif
+        case CHECKSUM_NONE:
+            break;
+    }
+    return estado;
+}
+
+// Atualização com um byte (caminho byte a byte das máquinas de estados)
+static inline uint16_t checksumUpdateByte(ChecksumAlgorithm alg, uint16_t estado, uint8_t byte) {
+    switch (alg) {
+        case CHECKSUM_SUM8:
+            return (uint8_t)(estado + byte);
+        case CHECKSUM_XOR8:
+            return (uint8_t)(estado ^ byte);
+        default:
+            return checksumUpdate(alg, estado, &byte, 1);
+    }
+}
+
+// Confere o valor recebido no quadro (CHECKSUM_NONE sempre confere)
+static inline int checksumMatches(ChecksumAlgorithm alg, uint16_t calculado, uint16_t recebido) {
+    return alg == CHECKSUM_NONE || calculado == recebido;
+}
+
+#endif // FRAME_CHECKSUM_H
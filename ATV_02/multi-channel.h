@@ -0,0 +1,327 @@
+// Parser de muitos canais (enlaces seriais) com o estado em vetores
+// paralelos (struct-of-arrays) e os dados em segmentos de um pool.
+//
+// Um MaquinaEstados por canal custa ~300 bytes (256 deles de buffer) e os
+// campos de canais diferentes ficam espalhados. Aqui cada campo é um vetor
+// indexado pelo canal (12 bytes por canal no total). Quadro inteiro no
+// bloco é entregue direto da entrada, sem cópia e sem pool (como
+// processarBytes); só os dados de um quadro que atravessa o fim de um
+// bloco são guardados, em segmentos de MC_SEGMENTO bytes encadeados, tirados
+// do pool conforme os bytes chegam e devolvidos quando o quadro termina.
+// Assim o pool acompanha os bytes realmente pendentes, não 256 bytes por
+// quadro aberto. Um quadro maior que um segmento é remontado em 'montagem'
+// antes de ser entregue.
+//
+// Se o pool acabar, o quadro continua sendo acompanhado (tamanho, checksum,
+// ETX) para não perder o sincronismo, mas não é entregue: conta em
+// quadrosPerdidos.
+//
+// O algoritmo de checksum é o mesmo para todos os canais.
+
+#ifndef MULTI_CHANNEL_H
+#define MULTI_CHANNEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FSMswitchCase.h"
+
+#define MC_SEGMENTO 32                // Bytes por segmento do pool
+#define MC_SEGMENTOS_POR_QUADRO ((255 + MC_SEGMENTO - 1) / MC_SEGMENTO)
+#define MC_SEM_SEGMENTO 0xFFFF
+#define MC_QUADRO_PERDIDO 0xFFFE      // O pool acabou no meio deste quadro
+
+// Bytes recebidos de um canal (uma leitura de UART, um pacote do gateway)
+typedef struct {
+    uint16_t canal;
+    const uint8_t *dados;
+    size_t tamanho;
+} EntradaCanal;
+
+// Função chamada a cada quadro completo; 'dados' só vale durante a chamada
+typedef void (*AoReceberQuadroCanal)(uint16_t canal, const uint8_t *dados, size_t tamanho, void *contexto);
+
+typedef struct {
+    size_t canais;
+    // Estado por canal, um vetor por campo
+    uint8_t *estado;             // EstadoParser
+    uint8_t *tamanho;
+    uint8_t *indice;             // Bytes de dados já lidos
+    uint8_t *bytesChecksum;
+    uint16_t *checksum;          // Checksum recebido
+    uint16_t *checksumCalculado;
+    uint16_t *primeiro;          // Primeiro segmento dos dados guardados
+    uint16_t *ultimo;            // Último segmento (onde entra o próximo byte)
+    ChecksumAlgorithm algoritmo;
+    // Pool de segmentos
+    uint8_t (*pool)[MC_SEGMENTO];
+    uint16_t *proximo;           // Encadeamento dos segmentos de um quadro
+    uint16_t *livres;            // Pilha de segmentos livres
+    size_t segmentosPool;
+    size_t segmentosLivres;
+    size_t picoSegmentos;        // Maior número de segmentos em uso ao mesmo tempo
+    uint8_t montagem[256];       // Quadro de vários segmentos, remontado
+    // Estatísticas
+    size_t quadros;
+    size_t quadrosPerdidos;      // Válidos, mas sem espaço no pool
+    size_t quadrosRejeitados;    // ETX errado ou checksum que não confere
+    size_t entradasInvalidas;    // Blocos com canal fora do intervalo (ignorados)
+} ParserMultiCanal;
+
+// Função para criar o parser com 'canais' canais (até 65535) e um pool de
+// 'segmentos' segmentos (até 65533). Com 0, o pool é o do pior caso, um
+// quadro de 255 bytes aberto em todos os canais, e nenhum quadro é perdido
+// até 8191 canais; acima disso o pool fica no máximo de 65533 segmentos e
+// quadros podem ser perdidos. Retorna false se os parâmetros forem
+// inválidos ou faltar memória.
+static inline bool inicializarMultiCanal(ParserMultiCanal *p, size_t canais, size_t segmentos,
+                                         ChecksumAlgorithm algoritmo) {
+    memset(p, 0, sizeof(*p));
+    if (segmentos == 0) {
+        segmentos = canais * MC_SEGMENTOS_POR_QUADRO;
+        if (segmentos >= MC_QUADRO_PERDIDO) {
+            segmentos = MC_QUADRO_PERDIDO - 1;
+        }
+    }
+    if (canais == 0 || canais > 0xFFFF || segmentos >= MC_QUADRO_PERDIDO) {
+        return false;
+    }
+    p->canais = canais;
+    p->algoritmo = algoritmo;
+    p->estado = calloc(canais, 1);
+    p->tamanho = calloc(canais, 1);
+    p->indice = calloc(canais, 1);
+    p->bytesChecksum = calloc(canais, 1);
+    p->checksum = calloc(canais, sizeof(uint16_t));
+    p->checksumCalculado = calloc(canais, sizeof(uint16_t));
+    p->primeiro = malloc(canais * sizeof(uint16_t));
+    p->ultimo = malloc(canais * sizeof(uint16_t));
+    p->pool = malloc(segmentos * sizeof(*p->pool));
+    p->proximo = malloc(segmentos * sizeof(uint16_t));
+    p->livres = malloc(segmentos * sizeof(uint16_t));
+    if (!p->estado || !p->tamanho || !p->indice || !p->bytesChecksum || !p->checksum ||
+        !p->checksumCalculado || !p->primeiro || !p->ultimo || !p->pool || !p->proximo || !p->livres) {
+        return false;  // liberarMultiCanal libera o que foi alocado
+    }
+    for (size_t c = 0; c < canais; c++) {
+        p->estado[c] = ESPERANDO_STX;
+        p->primeiro[c] = MC_SEM_SEGMENTO;
+        p->ultimo[c] = MC_SEM_SEGMENTO;
+    }
+    for (size_t s = 0; s < segmentos; s++) {
+        p->livres[s] = (uint16_t)(segmentos - 1 - s);
+    }
+    p->segmentosPool = segmentos;
+    p->segmentosLivres = segmentos;
+    return true;
+}
+
+static inline void liberarMultiCanal(ParserMultiCanal *p) {
+    free(p->estado);
+    free(p->tamanho);
+    free(p->indice);
+    free(p->bytesChecksum);
+    free(p->checksum);
+    free(p->checksumCalculado);
+    free(p->primeiro);
+    free(p->ultimo);
+    free(p->pool);
+    free(p->proximo);
+    free(p->livres);
+    memset(p, 0, sizeof(*p));
+}
+
+// Bytes de estado por canal, sem contar o pool
+static inline size_t bytesPorCanal(void) {
+    return 4 * sizeof(uint8_t) + 4 * sizeof(uint16_t);
+}
+
+// Devolve ao pool os segmentos de um quadro
+static inline void devolverSegmentos(ParserMultiCanal *p, uint16_t s) {
+    while (s != MC_SEM_SEGMENTO && s != MC_QUADRO_PERDIDO) {
+        uint16_t seguinte = p->proximo[s];
+        p->livres[p->segmentosLivres++] = s;
+        s = seguinte;
+    }
+}
+
+// Guarda n bytes de dados a partir da posição 'indice' do quadro, tirando
+// segmentos do pool quando o último enche. Se o pool acabar, devolve os
+// segmentos do quadro e o marca como MC_QUADRO_PERDIDO.
+static inline void guardarDados(ParserMultiCanal *p, uint16_t *primeiro, uint16_t *ultimo, size_t indice,
+                                const uint8_t *origem, size_t n) {
+    if (*primeiro == MC_QUADRO_PERDIDO) {
+        return;
+    }
+    while (n) {
+        size_t deslocamento = indice % MC_SEGMENTO;
+        if (deslocamento == 0) {
+            if (p->segmentosLivres == 0) {
+                devolverSegmentos(p, *primeiro);
+                *primeiro = MC_QUADRO_PERDIDO;
+                return;
+            }
+            uint16_t s = p->livres[--p->segmentosLivres];
+            size_t emUso = p->segmentosPool - p->segmentosLivres;
+            if (emUso > p->picoSegmentos) {
+                p->picoSegmentos = emUso;
+            }
+            p->proximo[s] = MC_SEM_SEGMENTO;
+            if (*primeiro == MC_SEM_SEGMENTO) {
+                *primeiro = s;
+            } else {
+                p->proximo[*ultimo] = s;
+            }
+            *ultimo = s;
+        }
+        size_t m = MC_SEGMENTO - deslocamento;
+        if (m > n) {
+            m = n;
+        }
+        memcpy(&p->pool[*ultimo][deslocamento], origem, m);
+        origem += m;
+        indice += m;
+        n -= m;
+    }
+}
+
+// Dados contíguos de um quadro guardado em segmentos
+static inline const uint8_t *remontarDados(ParserMultiCanal *p, uint16_t s, size_t tamanho) {
+    if (tamanho <= MC_SEGMENTO) {
+        return p->pool[s];
+    }
+    for (size_t i = 0; i < tamanho; i += MC_SEGMENTO, s = p->proximo[s]) {
+        size_t m = tamanho - i < MC_SEGMENTO ? tamanho - i : MC_SEGMENTO;
+        memcpy(&p->montagem[i], p->pool[s], m);
+    }
+    return p->montagem;
+}
+
+// Função para processar um bloco de bytes de um canal. O estado do canal é
+// lido dos vetores para variáveis locais, o bloco é varrido como em
+// processarBytes (memchr até o STX, dados sem cópia quando cabem no bloco)
+// e o estado é gravado de volta no fim. Retorna quantos quadros foram
+// entregues; um canal fora do intervalo é ignorado (0 quadros) e conta em
+// entradasInvalidas.
+static inline size_t processarCanal(ParserMultiCanal *p, uint16_t canal, const uint8_t *buf, size_t n,
+                                    AoReceberQuadroCanal aoReceberQuadro, void *contexto) {
+    if (canal >= p->canais) {
+        p->entradasInvalidas++;
+        return 0;
+    }
+    uint8_t estado = p->estado[canal];
+    uint8_t tamanho = p->tamanho[canal];
+    uint8_t indice = p->indice[canal];
+    uint8_t bytesChecksum = p->bytesChecksum[canal];
+    uint16_t checksum = p->checksum[canal];
+    uint16_t calculado = p->checksumCalculado[canal];
+    uint16_t primeiro = p->primeiro[canal];
+    uint16_t ultimo = p->ultimo[canal];
+    const ChecksumAlgorithm alg = p->algoritmo;
+    const uint8_t *semCopia = NULL;  // Dados do quadro atual dentro de 'buf'
+    size_t i = 0, quadros = 0;
+
+    while (i < n) {
+        switch (estado) {
+            case LENDO_TAMANHO:
+                tamanho = buf[i++];
+                calculado = checksumUpdateByte(alg, calculado, tamanho);
+                checksum = 0;
+                bytesChecksum = 0;
+                estado = tamanho ? LENDO_DADOS : LENDO_CHECKSUM;
+                break;
+            case LENDO_DADOS: {
+                size_t k = (size_t)(tamanho - indice);
+                if (indice == 0 && k <= n - i) {
+                    semCopia = buf + i;
+                } else {
+                    if (k > n - i) {
+                        k = n - i;
+                    }
+                    guardarDados(p, &primeiro, &ultimo, indice, buf + i, k);
+                }
+                calculado = checksumUpdate(alg, calculado, buf + i, k);
+                indice += (uint8_t)k;
+                i += k;
+                if (indice == tamanho) {
+                    estado = LENDO_CHECKSUM;
+                }
+                break;
+            }
+            case LENDO_CHECKSUM:
+                checksum = (uint16_t)((checksum << 8) | buf[i++]);
+                if (++bytesChecksum == checksumSize(alg)) {
+                    estado = ESPERANDO_ETX;
+                }
+                break;
+            case ESPERANDO_ETX:
+                if (buf[i++] == ETX && checksumMatches(alg, calculado, checksum)) {
+                    if (primeiro == MC_QUADRO_PERDIDO) {
+                        p->quadrosPerdidos++;
+                    } else {
+                        quadros++;
+                        if (aoReceberQuadro) {
+                            const uint8_t *dados = semCopia ? semCopia
+                                                 : tamanho  ? remontarDados(p, primeiro, tamanho)
+                                                            : buf;
+                            aoReceberQuadro(canal, dados, tamanho, contexto);
+                        }
+                    }
+                } else {
+                    p->quadrosRejeitados++;
+                }
+                devolverSegmentos(p, primeiro);
+                primeiro = MC_SEM_SEGMENTO;
+                semCopia = NULL;
+                estado = ESPERANDO_STX;
+                break;
+            default: {  // ESPERANDO_STX
+                const uint8_t *stx = (const uint8_t *)memchr(buf + i, STX, n - i);
+                if (stx == NULL) {
+                    i = n;
+                    break;
+                }
+                i = (size_t)(stx - buf) + 1;
+                indice = 0;
+                calculado = checksumInit(alg);
+                estado = LENDO_TAMANHO;
+                break;
+            }
+        }
+    }
+
+    // Dados sem cópia de um quadro ainda aberto: 'buf' não vale depois
+    // desta chamada, então agora eles vão para o pool
+    if (semCopia != NULL) {
+        guardarDados(p, &primeiro, &ultimo, 0, semCopia, tamanho);
+    }
+
+    p->estado[canal] = estado;
+    p->tamanho[canal] = tamanho;
+    p->indice[canal] = indice;
+    p->bytesChecksum[canal] = bytesChecksum;
+    p->checksum[canal] = checksum;
+    p->checksumCalculado[canal] = calculado;
+    p->primeiro[canal] = primeiro;
+    p->ultimo[canal] = ultimo;
+    p->quadros += quadros;
+    return quadros;
+}
+
+// Função para processar de uma vez blocos de vários canais (por exemplo,
+// tudo o que o gateway recebeu desde a última chamada). Retorna quantos
+// quadros foram entregues.
+static inline size_t processarLote(ParserMultiCanal *p, const EntradaCanal *entradas, size_t n,
+                                   AoReceberQuadroCanal aoReceberQuadro, void *contexto) {
+    size_t quadros = 0;
+    for (size_t e = 0; e < n; e++) {
+        quadros += processarCanal(p, entradas[e].canal, entradas[e].dados, entradas[e].tamanho,
+                                  aoReceberQuadro, contexto);
+    }
+    return quadros;
+}
+
+#endif // MULTI_CHANNEL_H
@@ -0,0 +1,465 @@
+// Decodificação paralela de uma captura inteira em memória (ex.: arquivo
+// mapeado com mmap), com o mesmo resultado de um único processarBytes
+// sobre ela: mesmos quadros, na mesma ordem, e mesmos bytesDescartados e
+// quadrosRecuperados.
+//
+// A decodificação é uma cadeia de candidatos: a partir de uma posição de
+// busca, o próximo STX é um candidato; um quadro válido leva a busca para
+// depois do ETX, um rejeitado para o byte seguinte ao STX (com
+// ressincronização) ou para depois do byte no lugar do ETX (sem). Como o
+// passo só depende da posição do candidato, duas cadeias que passam pelo
+// mesmo candidato seguem iguais dali em diante.
+//
+// A captura é dividida em pedaços. Cada thread percorre um pedaço a partir
+// do seu início, como se ali não houvesse quadro aberto (cadeia
+// especulativa), e guarda os candidatos da cabeça (PEDACO_CABECA bytes a
+// partir do primeiro candidato).
+// A thread principal costura os pedaços em ordem: a cadeia verdadeira
+// entra no pedaço onde a do pedaço anterior saiu (um quadro que atravessa
+// a divisa é lido inteiro por quem tem o STX) e é percorrida até achar um
+// candidato da cabeça. Daí em diante vale o que a thread já contou. Se não
+// houver encontro na cabeça (ex.: uma longa sequência de STX falsos sem
+// ressincronização), o pedaço é percorrido de novo em série. Assim nenhum
+// quadro da divisa se perde ou sai duas vezes.
+//
+// Os quadros são entregues a aoDecodificarQuadro pela thread principal,
+// em ordem, apontando direto para a captura. Só os pedaços entre o último
+// costurado e as threads ficam em memória (posição dos quadros válidos).
+//
+// Compilação: com -pthread.
+
+#ifndef PARALLEL_DECODER_H
+#define PARALLEL_DECODER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "frame-checksum.h"
+#include "stx-scan.h"
+
+#define PEDACO_CABECA 4096              // Bytes guardados no início de cada pedaço para a costura
+#define PEDACO_MAXIMO (1u << 30)        // Posições relativas ao pedaço cabem em 32 bits
+#define QUADRO_MAXIMO (3 + 255 + 2)     // STX + LEN + 255 dados + 2 de checksum + ETX
+
+// Resultado de um candidato
+typedef enum {
+    QUADRO_VALIDO,
+    QUADRO_ETX_ERRADO,
+    QUADRO_CHECKSUM_ERRADO,
+    QUADRO_INCOMPLETO       // Passa do fim da captura
+} ResultadoQuadro;
+
+// Contadores da cadeia
+typedef struct {
+    size_t quadros;         // Quadros válidos
+    size_t bytesQuadros;    // Bytes dentro de quadros válidos (STX a ETX)
+    size_t etxErrado;       // Candidatos com outro byte no lugar do ETX
+    size_t checksumErrado;  // Candidatos com ETX certo e checksum que não confere
+    size_t recuperados;     // Quadros válidos dentro de um rejeitado (ressincronização)
+} ContagemCaptura;
+
+// Função chamada a cada quadro válido: posição do STX na captura e dados
+typedef void (*AoDecodificarQuadro)(size_t posicao, const uint8_t *dados, size_t tamanho, void *contexto);
+
+typedef struct {
+    ChecksumAlgorithm algoritmo;
+    bool ressincronizar;
+    unsigned threads;           // 1: tudo em série na thread que chama
+    size_t tamanhoPedaco;       // 0: automático
+    // Resultado da última decodificarCaptura
+    ContagemCaptura contagem;
+    size_t bytesDescartados;    // Como em MaquinaEstados
+    size_t bytesPendentes;      // Quadro incompleto no fim da captura
+    size_t pedacos;
+    size_t pedacosRefeitos;     // Percorridos de novo em série na costura
+} DecodificadorCaptura;
+
+// Função para inicializar o decodificador
+static inline void inicializarDecodificador(DecodificadorCaptura *d, ChecksumAlgorithm algoritmo,
+                                            bool ressincronizar, unsigned threads) {
+    d->algoritmo = algoritmo;
+    d->ressincronizar = ressincronizar;
+    d->threads = threads ? threads : 1;
+    d->tamanhoPedaco = 0;
+    d->contagem = (ContagemCaptura){0, 0, 0, 0, 0};
+    d->bytesDescartados = 0;
+    d->bytesPendentes = 0;
+    d->pedacos = 0;
+    d->pedacosRefeitos = 0;
+}
+
+// Confere o quadro que começa no STX em 'stx', com 'disponivel' bytes até o
+// fim da captura (as mesmas verificações de processarByte)
+static inline ResultadoQuadro verificarQuadro(ChecksumAlgorithm alg, const uint8_t *stx, size_t disponivel) {
+    size_t k = checksumSize(alg);
+    if (disponivel < 2 || disponivel < 3 + (size_t)stx[1] + k) {
+        return QUADRO_INCOMPLETO;
+    }
+    size_t n = stx[1];
+    if (stx[2 + n + k] != STX_SCAN_ETX) {
+        return QUADRO_ETX_ERRADO;
+    }
+    uint16_t recebido = k == 2 ? (uint16_t)(stx[2 + n] << 8 | stx[3 + n]) : stx[2 + n];
+    uint16_t calculado = checksumUpdate(alg, checksumInit(alg), stx + 1, n + 1);
+    return checksumMatches(alg, calculado, recebido) ? QUADRO_VALIDO : QUADRO_CHECKSUM_ERRADO;
+}
+
+// ---- Cadeia de candidatos ----
+
+typedef struct {
+    const uint8_t *buf;
+    size_t tamanho;
+    ChecksumAlgorithm algoritmo;
+    bool ressincronizar;
+    ContagemCaptura contagem;
+    size_t maiorFim;            // Maior fim de quadro rejeitado até aqui
+    size_t pendente;            // Posição do quadro incompleto, ou SIZE_MAX
+    AoDecodificarQuadro aoDecodificarQuadro;
+    void *contexto;
+} CadeiaCaptura;
+
+static inline void iniciarCadeia(CadeiaCaptura *c, const DecodificadorCaptura *d, const uint8_t *buf,
+                                 size_t tamanho, AoDecodificarQuadro aoDecodificarQuadro, void *contexto) {
+    c->buf = buf;
+    c->tamanho = tamanho;
+    c->algoritmo = d->algoritmo;
+    c->ressincronizar = d->ressincronizar;
+    c->contagem = (ContagemCaptura){0, 0, 0, 0, 0};
+    c->maiorFim = 0;
+    c->pendente = SIZE_MAX;
+    c->aoDecodificarQuadro = aoDecodificarQuadro;
+    c->contexto = contexto;
+}
+
+// Conta o candidato em 's' e devolve a próxima posição de busca
+static inline size_t passoCadeia(CadeiaCaptura *c, size_t s, ResultadoQuadro r) {
+    if (r == QUADRO_INCOMPLETO) {
+        c->pendente = s;
+        return c->tamanho;
+    }
+    size_t n = c->buf[s + 1];
+    size_t fim = s + 3 + n + checksumSize(c->algoritmo);
+    if (r == QUADRO_VALIDO) {
+        c->contagem.quadros++;
+        c->contagem.bytesQuadros += fim - s;
+        c->contagem.recuperados += s < c->maiorFim;
+        if (c->aoDecodificarQuadro) {
+            c->aoDecodificarQuadro(s, c->buf + s + 2, n, c->contexto);
+        }
+        return fim;
+    }
+    if (r == QUADRO_ETX_ERRADO) {
+        c->contagem.etxErrado++;
+    } else {
+        c->contagem.checksumErrado++;
+    }
+    if (!c->ressincronizar) {
+        return fim;
+    }
+    if (c->maiorFim < fim) {
+        c->maiorFim = fim;
+    }
+    return s + 1;
+}
+
+// Percorre a cadeia a partir da posição de busca 'p' enquanto os
+// candidatos estiverem antes de 'limite'; devolve onde a busca parou
+static inline size_t percorrerCadeia(CadeiaCaptura *c, size_t p, size_t limite) {
+    while (p < c->tamanho) {
+        const uint8_t *stx = stxFind(c->buf + p, c->buf + c->tamanho);
+        if (stx == NULL) {
+            return c->tamanho;
+        }
+        size_t s = (size_t)(stx - c->buf);
+        if (s >= limite) {
+            return s;
+        }
+        p = passoCadeia(c, s, verificarQuadro(c->algoritmo, stx, c->tamanho - s));
+    }
+    return p;
+}
+
+// ---- Pedaços ----
+
+typedef struct {
+    size_t inicio, fim;
+    uint64_t *cabeca;           // Candidatos antes de limiteCabeca: posição << 2 | resultado
+    size_t nCabeca, capCabeca;
+    uint32_t *quadros;          // Quadros válidos depois da cabeça (posição - inicio)
+    size_t nQuadros, capQuadros;
+    size_t limiteCabeca;        // Primeiro candidato + PEDACO_CABECA
+    ContagemCaptura cauda;      // Contadores depois da cabeça
+    size_t maiorFimCauda;       // Maior fim de quadro rejeitado depois da cabeça
+    size_t saida;               // Posição de busca em que a cadeia deixou o pedaço
+    size_t pendente;
+    bool falhou;                // Sem memória: a costura percorre o pedaço em série
+    bool pronto;
+} PedacoCaptura;
+
+typedef struct {
+    DecodificadorCaptura *d;
+    const uint8_t *buf;
+    size_t tamanho;
+    PedacoCaptura *pedacos;
+    size_t nPedacos;
+    bool registrarQuadros;      // Há aoDecodificarQuadro
+    size_t proximo;             // Próximo pedaço a pegar
+    size_t costurados;          // Pedaços já costurados (libera a janela)
+    size_t janela;
+    pthread_mutex_t trava;
+    pthread_cond_t mudou;
+} TrabalhoCaptura;
+
+static inline bool crescerVetor(void **v, size_t *capacidade, size_t tamanhoItem) {
+    size_t nova = *capacidade ? 2 * *capacidade : 256;
+    void *p = realloc(*v, nova * tamanhoItem);
+    if (p == NULL) {
+        return false;
+    }
+    *v = p;
+    *capacidade = nova;
+    return true;
+}
+
+static void registrarQuadroPedaco(size_t posicao, const uint8_t *dados, size_t tamanho, void *contexto) {
+    PedacoCaptura *p = (PedacoCaptura *)contexto;
+    (void)dados;
+    (void)tamanho;
+    if (posicao < p->limiteCabeca || p->falhou) {
+        return;
+    }
+    if (p->nQuadros == p->capQuadros && !crescerVetor((void **)&p->quadros, &p->capQuadros, sizeof(uint32_t))) {
+        p->falhou = true;
+        return;
+    }
+    p->quadros[p->nQuadros++] = (uint32_t)(posicao - p->inicio);
+}
+
+// Cadeia especulativa de um pedaço (executada pelas threads). A cabeça vai
+// do primeiro candidato até PEDACO_CABECA bytes depois dele.
+static inline void percorrerPedaco(TrabalhoCaptura *t, PedacoCaptura *p) {
+    CadeiaCaptura c;
+    iniciarCadeia(&c, t->d, t->buf, t->tamanho, t->registrarQuadros ? registrarQuadroPedaco : NULL, p);
+    ContagemCaptura cabeca = c.contagem;
+    size_t pos = p->inicio;
+    p->limiteCabeca = SIZE_MAX;
+    p->maiorFimCauda = 0;
+    while (pos < t->tamanho) {
+        const uint8_t *stx = stxFind(t->buf + pos, t->buf + t->tamanho);
+        if (stx == NULL) {
+            pos = t->tamanho;
+            break;
+        }
+        size_t s = (size_t)(stx - t->buf);
+        if (s >= p->fim) {
+            pos = s;
+            break;
+        }
+        if (p->limiteCabeca == SIZE_MAX) {
+            p->limiteCabeca = s + PEDACO_CABECA;
+        }
+        ResultadoQuadro r = verificarQuadro(c.algoritmo, stx, t->tamanho - s);
+        if (s < p->limiteCabeca) {
+            if (p->nCabeca == p->capCabeca && !crescerVetor((void **)&p->cabeca, &p->capCabeca, sizeof(uint64_t))) {
+                p->falhou = true;
+                return;
+            }
+            p->cabeca[p->nCabeca++] = (uint64_t)s << 2 | r;
+            pos = passoCadeia(&c, s, r);
+            cabeca = c.contagem;
+        } else {
+            pos = passoCadeia(&c, s, r);
+            if (c.ressincronizar && (r == QUADRO_ETX_ERRADO || r == QUADRO_CHECKSUM_ERRADO)) {
+                size_t fim = s + 3 + t->buf[s + 1] + checksumSize(c.algoritmo);
+                if (p->maiorFimCauda < fim) {
+                    p->maiorFimCauda = fim;
+                }
+            }
+        }
+    }
+    p->cauda.quadros = c.contagem.quadros - cabeca.quadros;
+    p->cauda.bytesQuadros = c.contagem.bytesQuadros - cabeca.bytesQuadros;
+    p->cauda.etxErrado = c.contagem.etxErrado - cabeca.etxErrado;
+    p->cauda.checksumErrado = c.contagem.checksumErrado - cabeca.checksumErrado;
+    p->cauda.recuperados = c.contagem.recuperados - cabeca.recuperados;
+    p->saida = pos;
+    p->pendente = c.pendente;
+}
+
+static void *trabalharCaptura(void *arg) {
+    TrabalhoCaptura *t = (TrabalhoCaptura *)arg;
+    for (;;) {
+        pthread_mutex_lock(&t->trava);
+        while (t->proximo < t->nPedacos && t->proximo >= t->costurados + t->janela) {
+            pthread_cond_wait(&t->mudou, &t->trava);
+        }
+        if (t->proximo == t->nPedacos) {
+            pthread_mutex_unlock(&t->trava);
+            return NULL;
+        }
+        PedacoCaptura *p = &t->pedacos[t->proximo++];
+        pthread_mutex_unlock(&t->trava);
+
+        percorrerPedaco(t, p);
+
+        pthread_mutex_lock(&t->trava);
+        p->pronto = true;
+        pthread_cond_broadcast(&t->mudou);
+        pthread_mutex_unlock(&t->trava);
+    }
+}
+
+// Continua a cadeia verdadeira 'c' pelo pedaço 'p' a partir da posição de
+// busca 'pos'; devolve a posição de busca em que ela sai do pedaço
+static inline size_t costurarPedaco(DecodificadorCaptura *d, CadeiaCaptura *c, const PedacoCaptura *p, size_t pos) {
+    size_t j = 0;
+    bool refeito = p->falhou;
+    d->pedacosRefeitos += refeito;
+    while (pos < c->tamanho) {
+        const uint8_t *stx = stxFind(c->buf + pos, c->buf + c->tamanho);
+        if (stx == NULL) {
+            return c->tamanho;
+        }
+        size_t s = (size_t)(stx - c->buf);
+        if (s >= p->fim) {
+            return s;
+        }
+        if (!refeito) {
+            while (j < p->nCabeca && (size_t)(p->cabeca[j] >> 2) < s) {
+                j++;
+            }
+            if (s + QUADRO_MAXIMO > p->limiteCabeca) {
+                // Sem encontro a tempo: os quadros depois da cabeça podem
+                // depender do que veio antes (recuperados)
+                refeito = true;
+                d->pedacosRefeitos++;
+            } else if (j < p->nCabeca && (size_t)(p->cabeca[j] >> 2) == s) {
+                // Mesmo candidato: o resto da cabeça e a cauda valem
+                for (; j < p->nCabeca; j++) {
+                    passoCadeia(c, (size_t)(p->cabeca[j] >> 2), (ResultadoQuadro)(p->cabeca[j] & 3));
+                }
+                c->contagem.quadros += p->cauda.quadros;
+                c->contagem.bytesQuadros += p->cauda.bytesQuadros;
+                c->contagem.etxErrado += p->cauda.etxErrado;
+                c->contagem.checksumErrado += p->cauda.checksumErrado;
+                c->contagem.recuperados += p->cauda.recuperados;
+                if (c->aoDecodificarQuadro) {
+                    for (size_t q = 0; q < p->nQuadros; q++) {
+                        size_t s2 = p->inicio + p->quadros[q];
+                        c->aoDecodificarQuadro(s2, c->buf + s2 + 2, c->buf[s2 + 1], c->contexto);
+                    }
+                }
+                if (c->maiorFim < p->maiorFimCauda) {
+                    c->maiorFim = p->maiorFimCauda;
+                }
+                if (p->pendente != SIZE_MAX) {
+                    c->pendente = p->pendente;
+                }
+                return p->saida;
+            }
+        }
+        pos = passoCadeia(c, s, verificarQuadro(c->algoritmo, stx, c->tamanho - s));
+    }
+    return pos;
+}
+
+static inline void liberarPedaco(PedacoCaptura *p) {
+    free(p->cabeca);
+    free(p->quadros);
+    p->cabeca = NULL;
+    p->quadros = NULL;
+}
+
+static inline void terminarDecodificacao(DecodificadorCaptura *d, const CadeiaCaptura *c, size_t tamanho) {
+    d->contagem = c->contagem;
+    d->bytesPendentes = c->pendente == SIZE_MAX ? 0 : tamanho - c->pendente;
+    d->bytesDescartados = tamanho - c->contagem.bytesQuadros - d->bytesPendentes;
+}
+
+// Função para decodificar a captura 'buf' inteira. Chama aoDecodificarQuadro
+// (se não for NULL) a cada quadro válido, em ordem, na thread que chamou, e
+// deixa os contadores em 'd'. Com d->threads == 1, ou se não for possível
+// criar threads, percorre a captura em série. Retorna quantos quadros
+// foram decodificados.
+static inline size_t decodificarCaptura(DecodificadorCaptura *d, const uint8_t *buf, size_t tamanho,
+                                        AoDecodificarQuadro aoDecodificarQuadro, void *contexto) {
+    CadeiaCaptura c;
+    iniciarCadeia(&c, d, buf, tamanho, aoDecodificarQuadro, contexto);
+    d->pedacosRefeitos = 0;
+
+    size_t pedaco = d->tamanhoPedaco;
+    if (pedaco == 0) {
+        pedaco = tamanho / (8 * (size_t)d->threads) + 1;
+        if (pedaco < 4 * 1024 * 1024) pedaco = 4 * 1024 * 1024;
+    }
+    if (pedaco > PEDACO_MAXIMO) pedaco = PEDACO_MAXIMO;
+    size_t nPedacos = tamanho / pedaco + (tamanho % pedaco != 0);
+
+    TrabalhoCaptura t;
+    pthread_t *threads = NULL;
+    unsigned criadas = 0;
+    t.pedacos = NULL;
+    if (d->threads > 1 && nPedacos > 1) {
+        t.pedacos = (PedacoCaptura *)calloc(nPedacos, sizeof(PedacoCaptura));
+        threads = (pthread_t *)malloc(d->threads * sizeof(pthread_t));
+    }
+    if (t.pedacos && threads) {
+        t.d = d;
+        t.buf = buf;
+        t.tamanho = tamanho;
+        t.nPedacos = nPedacos;
+        t.registrarQuadros = aoDecodificarQuadro != NULL;
+        t.proximo = 0;
+        t.costurados = 0;
+        t.janela = 2 * (size_t)d->threads;
+        for (size_t k = 0; k < nPedacos; k++) {
+            t.pedacos[k].inicio = k * pedaco;
+            t.pedacos[k].fim = k + 1 == nPedacos ? tamanho : (k + 1) * pedaco;
+        }
+        pthread_mutex_init(&t.trava, NULL);
+        pthread_cond_init(&t.mudou, NULL);
+        while (criadas < d->threads && pthread_create(&threads[criadas], NULL, trabalharCaptura, &t) == 0) {
+            criadas++;
+        }
+    }
+
+    if (criadas == 0) {
+        d->pedacos = 1;
+        percorrerCadeia(&c, 0, tamanho);
+    } else {
+        d->pedacos = nPedacos;
+        size_t pos = 0;
+        for (size_t k = 0; k < nPedacos; k++) {
+            PedacoCaptura *p = &t.pedacos[k];
+            pthread_mutex_lock(&t.trava);
+            while (!p->pronto) {
+                pthread_cond_wait(&t.mudou, &t.trava);
+            }
+            pthread_mutex_unlock(&t.trava);
+
+            pos = costurarPedaco(d, &c, p, pos);
+            liberarPedaco(p);
+
+            pthread_mutex_lock(&t.trava);
+            t.costurados = k + 1;
+            pthread_cond_broadcast(&t.mudou);
+            pthread_mutex_unlock(&t.trava);
+        }
+        for (unsigned i = 0; i < criadas; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    if (t.pedacos && threads) {
+        pthread_mutex_destroy(&t.trava);
+        pthread_cond_destroy(&t.mudou);
+    }
+    free(threads);
+    free(t.pedacos);
+    terminarDecodificacao(d, &c, tamanho);
+    return c.contagem.quadros;
+}
+
+#endif // PARALLEL_DECODER_H
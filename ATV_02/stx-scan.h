@@ -0,0 +1,165 @@
+// Busca do STX em blocos de captura, compartilhada pelos parsers em bloco
+// da ATV_02 (processarBytes) e da ATV_03 (parseBytes).
+//
+// A maior parte de uma captura é preenchimento de linha ociosa, então o
+// parser passa quase todo o tempo procurando o próximo STX. Implementações:
+//
+//   stxFindAvx2     32 bytes por comparação (-mavx2)
+//   stxFindSse2     16 bytes por comparação (padrão em x86-64)
+//   stxFindScalar   palavra de 32 bits por vez (SWAR); é o padrão fora do
+//                   x86 ou com -DSTX_SCAN_SCALAR
+//
+// stxFind usa a mais larga disponível na compilação. stxFindFrame, além
+// de achar o candidato, confere o byte na posição em que o ETX deveria
+// estar (STX + 2 + LEN + bytes de checksum) e pula os candidatos falsos
+// sem entrar na máquina de estados.
+
+#ifndef STX_SCAN_H
+#define STX_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) && !defined(STX_SCAN_SCALAR)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__) && !defined(STX_SCAN_SCALAR)
+#include <immintrin.h>
+#endif
+
+#define STX_SCAN_STX 0x02
+#define STX_SCAN_ETX 0x03
+
+// ---- Escalar (SWAR) ----
+//
+// x = palavra ^ 0x02020202 tem um byte zero onde havia STX; o teste
+// (x - 0x01010101) & ~x & 0x80808080 é diferente de zero se algum byte
+// de x é zero. A palavra com STX é então percorrida byte a byte.
+
+static inline const uint8_t *stxFindScalar(const uint8_t *p, const uint8_t *end) {
+    for (; end - p >= 4; p += 4) {
+        uint32_t w;
+        memcpy(&w, p, sizeof(w));
+        w ^= 0x02020202u;
+        if ((w - 0x01010101u) & ~w & 0x80808080u) {
+            break;
+        }
+    }
+    for (; p < end; p++) {
+        if (*p == STX_SCAN_STX) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// ---- SSE2 / AVX2 ----
+//
+// Quatro comparações por volta (64 ou 128 bytes) combinadas com OR: em
+// trechos ociosos o laço só testa uma máscara por volta. O resto do bloco
+// (menos de uma volta) vai para a versão escalar.
+
+#if defined(__SSE2__) && !defined(STX_SCAN_SCALAR)
+static inline const uint8_t *stxFindSse2(const uint8_t *p, const uint8_t *end) {
+    const __m128i stx = _mm_set1_epi8(STX_SCAN_STX);
+    for (; end - p >= 64; p += 64) {
+        __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), stx);
+        __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 16)), stx);
+        __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 32)), stx);
+        __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 48)), stx);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)))) {
+            uint64_t m = (uint64_t)(unsigned)_mm_movemask_epi8(a) |
+                         (uint64_t)(unsigned)_mm_movemask_epi8(b) << 16 |
+                         (uint64_t)(unsigned)_mm_movemask_epi8(c) << 32 |
+                         (uint64_t)(unsigned)_mm_movemask_epi8(d) << 48;
+            return p + __builtin_ctzll(m);
+        }
+    }
+    for (; end - p >= 16; p += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), stx));
+        if (m) {
+            return p + __builtin_ctz(m);
+        }
+    }
+    return stxFindScalar(p, end);
+}
+#endif
+
+#if defined(__AVX2__) && !defined(STX_SCAN_SCALAR)
+static inline const uint8_t *stxFindAvx2(const uint8_t *p, const uint8_t *end) {
+    const __m256i stx = _mm256_set1_epi8(STX_SCAN_STX);
+    for (; end - p >= 128; p += 128) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), stx);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 32)), stx);
+        __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 64)), stx);
+        __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 96)), stx);
+        if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)))) {
+            uint64_t ab = (uint64_t)(uint32_t)_mm256_movemask_epi8(a) |
+                          (uint64_t)(uint32_t)_mm256_movemask_epi8(b) << 32;
+            if (ab) {
+                return p + __builtin_ctzll(ab);
+            }
+            uint64_t cd = (uint64_t)(uint32_t)_mm256_movemask_epi8(c) |
+                          (uint64_t)(uint32_t)_mm256_movemask_epi8(d) << 32;
+            return p + 64 + __builtin_ctzll(cd);
+        }
+    }
+    for (; end - p >= 32; p += 32) {
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), stx));
+        if (m) {
+            return p + __builtin_ctz(m);
+        }
+    }
+    return stxFindScalar(p, end);
+}
+#endif
+
+// Primeiro STX em [p, end), ou NULL
+#if defined(__AVX2__) && !defined(STX_SCAN_SCALAR)
+#define stxFind stxFindAvx2
+#define STX_SCAN_NAME "AVX2"
+#elif defined(__SSE2__) && !defined(STX_SCAN_SCALAR)
+#define stxFind stxFindSse2
+#define STX_SCAN_NAME "SSE2"
+#else
+#define stxFind stxFindScalar
+#define STX_SCAN_NAME "escalar"
+#endif
+
+// ---- Candidato validado ----
+//
+// Procura em [p, end) o próximo STX que pode começar um quadro: o ETX
+// está na posição esperada (STX + 2 + LEN + checksumBytes), ou ela (ou o
+// próprio LEN) fica além de 'end' e só o resto do fluxo dirá. Um
+// candidato com outro byte no lugar do ETX seria rejeitado pela máquina
+// de estados de qualquer forma e é pulado aqui, como ela faria: com
+// 'resync' a busca continua no byte seguinte ao STX falso; sem, depois do
+// quadro inteiro (o byte do ETX inclusive). *rejectedEnd (iniciado pelo
+// chamador com um ponteiro no mesmo bloco) avança até a posição seguinte
+// ao ETX de um candidato pulado, se ela estiver mais adiante.
+// Retorna NULL se não há candidato no bloco; todos os bytes de p até o
+// candidato (ou até 'end') ficam fora de qualquer quadro válido.
+
+static inline const uint8_t *stxFindFrame(const uint8_t *p, const uint8_t *end, size_t checksumBytes,
+                                          bool resync, const uint8_t **rejectedEnd) {
+    const uint8_t *stx;
+    while ((stx = stxFind(p, end)) != NULL) {
+        size_t left = (size_t)(end - stx);
+        if (left < 2) {
+            return stx;
+        }
+        size_t etx = 2 + (size_t)stx[1] + checksumBytes;
+        if (etx >= left || stx[etx] == STX_SCAN_ETX) {
+            return stx;
+        }
+        if (*rejectedEnd < stx + etx + 1) {
+            *rejectedEnd = stx + etx + 1;
+        }
+        p = resync ? stx + 1 : stx + etx + 1;
+    }
+    return NULL;
+}
+
+#endif // STX_SCAN_H
@@ -3,129 +3,404 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
+#include "FSMponteiroTabela.h"
+#include "dfa-parser.h"
+#include "frame-fsm.h"
 
-// Definição dos possíveis estados da FSM
-typedef enum {
-    FSM_STATE_INIT,
-    FSM_STATE_GET_LENGTH,
-    FSM_STATE_GET_PAYLOAD,
-    FSM_STATE_GET_CHECKSUM,
-    FSM_STATE_VERIFY_END,
-    FSM_STATE_SUCCESS,
-    FSM_STATE_FAILURE
-} FSMState;
+// Testes que falharam (código de saída do programa)
+int failures = 0;
 
-// Estrutura que representa a FSM
+// Função de teste da FSM
+void testStateMachine() {
+    StateMachine sm;
+    initializeStateMachine(&sm);
+
+    uint8_t message[] = {0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03};
+    bool completed = false;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        completed = processInput(&sm, message[i]);
+        if (completed) {
+            printf("Mensagem processada com sucesso!\n");
+            break;
+        }
+    }
+
+    if (!completed) {
+        printf("Falha ao processar a mensagem.\n");
+        failures++;
+    }
+}
+
+// Contexto do teste em bloco: soma dos payloads de todos os quadros recebidos
 typedef struct {
-    FSMState state;
-    uint8_t length;
-    uint8_t payload[256];
-    uint8_t checksum;
-    uint8_t index;
-} StateMachine;
-
-// Definição do tipo de função para os manipuladores de estado
-typedef bool (*StateFunction)(StateMachine *sm, uint8_t input);
-
-// Declaração das funções de manipulação de cada estado
-bool stateInit(StateMachine *sm, uint8_t input);
-bool stateGetLength(StateMachine *sm, uint8_t input);
-bool stateGetPayload(StateMachine *sm, uint8_t input);
-bool stateGetChecksum(StateMachine *sm, uint8_t input);
-bool stateVerifyEnd(StateMachine *sm, uint8_t input);
-
-// Tabela que mapeia cada estado à sua respectiva função manipuladora
-StateFunction stateFunctions[] = {
-    stateInit,
-    stateGetLength,
-    stateGetPayload,
-    stateGetChecksum,
-    stateVerifyEnd
-};
-
-
-// Função para inicializar ou resetar a FSM
-void initializeStateMachine(StateMachine *sm) {
-    sm->state = FSM_STATE_INIT;
-    sm->length = 0;
-    sm->checksum = 0;
-    sm->index = 0;
+    int frames;
+    unsigned sum;
+} BulkResult;
+
+static void countFrame(const StateMachine *sm, void *context) {
+    BulkResult *r = (BulkResult *)context;
+    r->frames++;
+    for (size_t i = 0; i < sm->view.len; i++) {
+        r->sum += sm->view.ptr[i];
+    }
 }
 
-// Função para manipular o estado inicial (aguardando STX)
-bool stateInit(StateMachine *sm, uint8_t input) {
-    if (input == 0x02) { // STX
-        sm->state = FSM_STATE_GET_LENGTH;
+// Teste do processamento em bloco: ruído entre quadros, quadros colados,
+// quadro vazio, ETX errado e o fluxo entregue em pedaços de todos os tamanhos
+void testParseBytes() {
+    uint8_t stream[] = {
+        0x55, 0xAA,                                   // ruído
+        0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03,        // quadro válido
+        0x02, 0x00, 0x00, 0x03,                       // colado ao anterior, sem payload
+        0x02, 0x02, 'Q', 'R', 0x00, 0x7F,             // ETX errado: descartado
+        0x01, 0x02, 0x04, 1, 2, 3, 4, 0x0A, 0x03      // ruído + quadro válido
+    };
+    BulkResult expected = {0, 0}, got = {0, 0};
+
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    for (size_t i = 0; i < sizeof(stream); i++) {
+        if (processInput(&sm, stream[i])) {
+            countFrame(&sm, &expected);
+        }
+    }
+
+    bool ok = expected.frames == 3;
+    for (size_t chunk = 1; chunk <= sizeof(stream) && ok; chunk++) {
+        initializeStateMachine(&sm);
+        got.frames = 0;
+        got.sum = 0;
+        size_t frames = 0;
+        for (size_t i = 0; i < sizeof(stream); i += chunk) {
+            size_t n = sizeof(stream) - i < chunk ? sizeof(stream) - i : chunk;
+            frames += parseBytes(&sm, stream + i, n, countFrame, &got);
+        }
+        ok = frames == 3 && got.frames == expected.frames && got.sum == expected.sum;
+    }
+
+    if (ok) {
+        printf("Processamento em bloco concluído com sucesso!\n");
+    } else {
+        printf("Falha no processamento em bloco.\n");
+        failures++;
     }
-    return false;
 }
 
-// Função para obter o comprimento do payload
-bool stateGetLength(StateMachine *sm, uint8_t input) {
-    sm->length = input;
-    sm->state = FSM_STATE_GET_PAYLOAD;
-    return false;
+// Teste da verificação do checksum: quadro com CRC-16 aceito e o mesmo
+// quadro com um bit trocado rejeitado, nos dois caminhos da FSM
+void testChecksum() {
+    uint8_t frame[] = {0x02, 0x05, 'H', 'E', 'L', 'L', 'O', 0x00, 0x00, 0x03};
+    uint16_t crc = checksumUpdate(CHECKSUM_CRC16_CCITT, checksumInit(CHECKSUM_CRC16_CCITT), &frame[1], 6);
+    frame[7] = (uint8_t)(crc >> 8);
+    frame[8] = (uint8_t)crc;
+
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    setChecksumAlgorithm(&sm, CHECKSUM_CRC16_CCITT);
+    bool accepted = false;
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        accepted = processInput(&sm, frame[i]);
+    }
+    size_t parsed = parseBytes(&sm, frame, sizeof(frame), NULL, NULL);
+
+    frame[4] ^= 0x01;
+    size_t corrupted = parseBytes(&sm, frame, sizeof(frame), NULL, NULL);
+    bool rejected = sm.state == FSM_STATE_FAILURE;
+
+    if (accepted && parsed == 1 && corrupted == 0 && rejected) {
+        printf("Verificação de checksum concluída com sucesso!\n");
+    } else {
+        printf("Falha na verificação de checksum.\n");
+        failures++;
+    }
 }
 
-// Função para obter o payload
-bool stateGetPayload(StateMachine *sm, uint8_t input) {
-    sm->payload[sm->index++] = input;
-    if (sm->index == sm->length) {
-        sm->state = FSM_STATE_GET_CHECKSUM;
+// Contexto do teste da visão: onde estava o payload de cada quadro
+typedef struct {
+    const uint8_t *ptr[2];
+    size_t len[2];
+    int frames;
+} ViewResult;
+
+static void saveView(const StateMachine *sm, void *context) {
+    ViewResult *r = (ViewResult *)context;
+    if (r->frames < 2) {
+        r->ptr[r->frames] = sm->view.ptr;
+        r->len[r->frames] = sm->view.len;
     }
-    return false;
+    r->frames++;
 }
 
-// Função para obter o checksum
-bool stateGetChecksum(StateMachine *sm, uint8_t input) {
-    sm->checksum = input;
-    sm->state = FSM_STATE_VERIFY_END;
-    return false;
+// Teste da visão sem cópia: quadro inteiro no bloco aponta para a entrada;
+// quadro que atravessa o fim do bloco usa o buffer interno
+void testFrameView() {
+    uint8_t stream[] = {0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03, 0x02, 0x04, 'K', 'L', 'M', 'N', 0x00, 0x03};
+    uint8_t copy[sizeof(stream)];
+    memcpy(copy, stream, sizeof(stream));
+    ViewResult r = {{NULL, NULL}, {0, 0}, 0};
+
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    parseBytes(&sm, copy, 10, saveView, &r);  // Corta o 2º quadro no payload
+    memset(copy, 0xEE, 10);                   // Quem chama reutiliza o bloco
+    parseBytes(&sm, copy + 10, sizeof(stream) - 10, saveView, &r);
+
+    bool ok = r.frames == 2 &&
+              r.ptr[0] == copy + 2 && r.len[0] == 3 &&
+              r.ptr[1] == sm.payload && r.len[1] == 4 && memcmp(sm.payload, "KLMN", 4) == 0;
+
+    // Payload completo mas ETX só no bloco seguinte: copiado ao fim da chamada
+    initializeStateMachine(&sm);
+    r.frames = 0;
+    memcpy(copy, stream, sizeof(stream));
+    parseBytes(&sm, copy, 6, saveView, &r);
+    memset(copy, 0xEE, 6);
+    parseBytes(&sm, copy + 6, 1, saveView, &r);
+    ok = ok && r.frames == 1 && r.ptr[0] == sm.payload && memcmp(sm.payload, "XYZ", 3) == 0;
+
+    if (ok) {
+        printf("Visão sem cópia concluída com sucesso!\n");
+    } else {
+        printf("Falha na visão sem cópia.\n");
+        failures++;
+    }
 }
 
-// Função para verificar o fim da mensagem
-bool stateVerifyEnd(StateMachine *sm, uint8_t input) {
-    if (input == 0x03) { // ETX
-        sm->state = FSM_STATE_SUCCESS;
-        return true;
+// Processa o fluxo em pedaços; retorna quadros e preenche 'r'
+static size_t parseInChunks(StateMachine *sm, const uint8_t *stream, size_t total, size_t chunk, BulkResult *r) {
+    size_t frames = 0;
+    r->frames = 0;
+    r->sum = 0;
+    for (size_t i = 0; i < total; i += chunk) {
+        size_t n = total - i < chunk ? total - i : chunk;
+        frames += parseBytes(sm, stream + i, n, countFrame, r);
+    }
+    return frames;
+}
+
+// Teste da ressincronização: dois quadros válidos escondidos no payload de
+// um quadro falso são recuperados em qualquer divisão do fluxo
+void testResync() {
+    uint8_t stream[] = {
+        0x02, 0x0A,                                   // STX falso, length 10
+        0x02, 0x01, 'X', 0x00, 0x03,                  // quadro válido
+        0x02, 0x02, 'Y', 'Z', 0x00, 0x03,             // quadro válido (o 0x03 é o "checksum" do falso)
+        0x55,                                         // no lugar do ETX do falso
+        0x02, 0x00, 0x00, 0x03                        // quadro válido depois do falso
+    };
+    StateMachine sm;
+    BulkResult r;
+
+    // Sem ressincronização o quadro falso engole os dois primeiros
+    initializeStateMachine(&sm);
+    bool ok = parseInChunks(&sm, stream, sizeof(stream), sizeof(stream), &r) == 1 &&
+              sm.bytesDiscarded == 14 && sm.framesRecovered == 0;
+
+    for (size_t chunk = 1; chunk <= sizeof(stream) && ok; chunk++) {
+        initializeStateMachine(&sm);
+        setResync(&sm, true);
+        ok = parseInChunks(&sm, stream, sizeof(stream), chunk, &r) == 3 &&
+             r.sum == 'X' + 'Y' + 'Z' && sm.framesRecovered == 2 && sm.bytesDiscarded == 3;
+    }
+
+    if (ok) {
+        printf("Ressincronização concluída com sucesso!\n");
+    } else {
+        printf("Falha na ressincronização.\n");
+        failures++;
+    }
+}
+
+// Teste da busca do STX no parseBytes: numa captura com linha ociosa e STX
+// soltos, pular os candidatos com ETX errado dá os mesmos quadros e
+// contadores que a FSM vendo um byte por vez (pedaço 1), com e sem resync
+void testStxScan() {
+    uint8_t stream[3000];
+    size_t total = 0;
+    unsigned seed = 3;
+    while (total + 80 < sizeof(stream)) {
+        seed = seed * 1103515245u + 12345u;
+        size_t idle = (seed >> 16) % 30;
+        for (size_t k = 0; k < idle; k++) {
+            seed = seed * 1103515245u + 12345u;
+            stream[total++] = (seed >> 16) % 6 == 0 ? FSM_STX : 0xFF;
+        }
+        uint8_t n = (uint8_t)((seed >> 20) % 40);
+        stream[total++] = FSM_STX;
+        stream[total++] = n;
+        for (int k = 0; k < n; k++) {
+            seed = seed * 1103515245u + 12345u;
+            stream[total++] = (uint8_t)(seed >> 16);
+        }
+        stream[total++] = 0x00;
+        stream[total++] = FSM_ETX;
+    }
+
+    bool ok = true;
+    for (int resync = 0; resync < 2 && ok; resync++) {
+        StateMachine sm;
+        BulkResult expected, r;
+        initializeStateMachine(&sm);
+        setResync(&sm, resync);
+        size_t frames = parseInChunks(&sm, stream, total, 1, &expected);
+        size_t discarded = sm.bytesDiscarded, recovered = sm.framesRecovered;
+        ok = frames > 0 && discarded > 0;
+
+        const size_t chunks[] = {total, 500, 48};
+        for (size_t k = 0; k < 3 && ok; k++) {
+            initializeStateMachine(&sm);
+            setResync(&sm, resync);
+            ok = parseInChunks(&sm, stream, total, chunks[k], &r) == frames && r.sum == expected.sum &&
+                 sm.bytesDiscarded == discarded && sm.framesRecovered == recovered;
+        }
+    }
+
+    if (ok) {
+        printf("Busca do STX concluída com sucesso!\n");
     } else {
-        sm->state = FSM_STATE_FAILURE;
+        printf("Falha na busca do STX.\n");
+        failures++;
     }
-    return false;
 }
 
-// Função para processar a entrada e avançar a FSM
-bool processInput(StateMachine *sm, uint8_t input) {
-    if (sm->state < FSM_STATE_SUCCESS) {
-        return stateFunctions[sm->state](sm, input);
+static void countDfaFrame(const DfaParser *p, void *context) {
+    BulkResult *r = (BulkResult *)context;
+    r->frames++;
+    for (int i = 0; i < p->r.length; i++) {
+        r->sum += p->payload[i];
     }
-    initializeStateMachine(sm);
-    return false;
 }
 
-// Função de teste da FSM
-void testStateMachine() {
+// Teste do autômato com tabela de transições: mesmo resultado da tabela de
+// ponteiros no fluxo com ruído, em pedaços, e CRC-16 aceito/rejeitado
+void testDfaParser() {
+    uint8_t stream[] = {
+        0x55, 0x03, 0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03,  // ruído com ETX + quadro válido
+        0x02, 0x00, 0x00, 0x03,                             // sem payload
+        0x02, 0x02, 0x02, 0x03, 0x00, 0x02,                 // STX/ETX no payload, ETX errado
+        0x02, 0x01, 0x03, 0x00, 0x03                        // logo após o rejeitado
+    };
+    BulkResult expected = {0, 0}, got = {0, 0};
+
     StateMachine sm;
     initializeStateMachine(&sm);
+    for (size_t i = 0; i < sizeof(stream); i++) {
+        if (processInput(&sm, stream[i])) {
+            countFrame(&sm, &expected);
+        }
+    }
 
-    uint8_t message[] = {0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03};
-    bool completed = false;
+    DfaParser p;
+    bool ok = expected.frames == 3;
+    for (size_t chunk = 1; chunk <= sizeof(stream) && ok; chunk++) {
+        initializeDfaParser(&p);
+        got.frames = 0;
+        got.sum = 0;
+        size_t frames = 0;
+        for (size_t i = 0; i < sizeof(stream); i += chunk) {
+            size_t n = sizeof(stream) - i < chunk ? sizeof(stream) - i : chunk;
+            frames += dfaParseBytes(&p, stream + i, n, countDfaFrame, &got);
+        }
+        ok = frames == 3 && got.frames == expected.frames && got.sum == expected.sum;
+    }
 
-    for (size_t i = 0; i < sizeof(message); i++) {
-        completed = processInput(&sm, message[i]);
-        if (completed) {
-            printf("Mensagem processada com sucesso!\n");
-            break;
+    uint8_t frame[] = {0x02, 0x03, 'C', 'R', 'C', 0x00, 0x00, 0x03};
+    uint16_t crc = checksumUpdate(CHECKSUM_CRC16_CCITT, checksumInit(CHECKSUM_CRC16_CCITT), &frame[1], 4);
+    frame[5] = (uint8_t)(crc >> 8);
+    frame[6] = (uint8_t)crc;
+    initializeDfaParser(&p);
+    setDfaChecksumAlgorithm(&p, CHECKSUM_CRC16_CCITT);
+    size_t accepted = dfaParseBytes(&p, frame, sizeof(frame), NULL, NULL);
+    frame[3] ^= 0x40;
+    size_t corrupted = dfaParseBytes(&p, frame, sizeof(frame), NULL, NULL);
+    ok = ok && accepted == 1 && corrupted == 0 && p.rejected;
+
+    if (ok) {
+        printf("Autômato com tabela de transições concluído com sucesso!\n");
+    } else {
+        printf("Falha no autômato com tabela de transições.\n");
+        failures++;
+    }
+}
+
+static void countGeneratedFrame(const FrameFsm *f, void *context) {
+    BulkResult *r = (BulkResult *)context;
+    r->frames++;
+    for (int i = 0; i < f->length; i++) {
+        r->sum += f->payload[i];
+    }
+}
+
+// Teste dos motores gerados de frame-fsm.h: switch, tabela e goto
+// computado dão o mesmo resultado da tabela de ponteiros escrita à mão, em
+// qualquer divisão do fluxo, e rejeitam o quadro com CRC-16 corrompido
+void testGeneratedEngines() {
+    uint8_t stream[] = {
+        0x55, 0x03, 0x02, 0x03, 'X', 'Y', 'Z', 0x07, 0x03,  // ruído com ETX + quadro válido
+        0x02, 0x00, 0x00, 0x03,                             // sem payload
+        0x02, 0x02, 0x02, 0x03, 0x00, 0x02,                 // STX/ETX no payload, ETX errado
+        0x02, 0x01, 0x03, 0x00, 0x03                        // logo após o rejeitado
+    };
+    BulkResult expected = {0, 0}, got;
+
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    for (size_t i = 0; i < sizeof(stream); i++) {
+        if (processInput(&sm, stream[i])) {
+            countFrame(&sm, &expected);
         }
     }
 
-    if (!completed) {
-        printf("Falha ao processar a mensagem.\n");
+    uint8_t frame[] = {0x02, 0x03, 'C', 'R', 'C', 0x00, 0x00, 0x03};
+    uint16_t crc = checksumUpdate(CHECKSUM_CRC16_CCITT, checksumInit(CHECKSUM_CRC16_CCITT), &frame[1], 4);
+    frame[5] = (uint8_t)(crc >> 8);
+    frame[6] = (uint8_t)crc;
+    uint8_t corrupted[sizeof(frame)];
+    memcpy(corrupted, frame, sizeof(frame));
+    corrupted[3] ^= 0x40;
+
+    FrameFsm f;
+    bool ok = expected.frames == 3;
+#define CHECK_ENGINE(engine)                                                                \
+    for (size_t chunk = 1; chunk <= sizeof(stream) && ok; chunk++) {                      \
+        frameFsmInit(&f);                                                                 \
+        got.frames = 0;                                                                   \
+        got.sum = 0;                                                                      \
+        size_t frames = 0;                                                                \
+        for (size_t i = 0; i < sizeof(stream); i += chunk) {                              \
+            size_t n = sizeof(stream) - i < chunk ? sizeof(stream) - i : chunk;           \
+            frames += frameFsmRun##engine(&f, stream + i, n, countGeneratedFrame, &got);  \
+        }                                                                                 \
+        ok = frames == 3 && f.rejected == 1 && got.frames == expected.frames &&           \
+             got.sum == expected.sum;                                                     \
+    }                                                                                     \
+    frameFsmInit(&f);                                                                     \
+    frameFsmSetChecksum(&f, CHECKSUM_CRC16_CCITT);                                        \
+    ok = ok && frameFsmRun##engine(&f, frame, sizeof(frame), NULL, NULL) == 1 &&          \
+         frameFsmRun##engine(&f, corrupted, sizeof(corrupted), NULL, NULL) == 0 &&        \
+         f.rejected == 1;
+    FRAME_FSM_ENGINES(CHECK_ENGINE)
+#undef CHECK_ENGINE
+
+    if (ok) {
+        printf("Motores gerados da descrição concluídos com sucesso!\n");
+    } else {
+        printf("Falha nos motores gerados da descrição.\n");
+        failures++;
     }
 }
 
 int main() {
     testStateMachine();
-    return 0;
+    testParseBytes();
+    testChecksum();
+    testFrameView();
+    testResync();
+    testStxScan();
+    testDfaParser();
+    testGeneratedEngines();
+    return failures != 0;
 }
@@ -0,0 +1,273 @@
+// Máquina de estados do quadro STX | LENGTH | PAYLOAD | CHECKSUM | ETX
+// usando ponteiros de função e tabela de estados.
+//
+// Um handler por estado na tabela; processInput e parseBytes compartilham o
+// checksum e a busca do STX da ATV_02. Teste:
+//   gcc -g FSMponteiroTabela.c -o FSMponteiroTabela
+
+#ifndef FSM_PONTEIRO_TABELA_H
+#define FSM_PONTEIRO_TABELA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../ATV_02/frame-checksum.h"
+#include "../ATV_02/stx-scan.h"
+
+#define FSM_STX 0x02
+#define FSM_ETX 0x03
+
+// Definição dos possíveis estados da FSM
+typedef enum {
+    FSM_STATE_INIT,
+    FSM_STATE_GET_LENGTH,
+    FSM_STATE_GET_PAYLOAD,
+    FSM_STATE_GET_CHECKSUM,
+    FSM_STATE_VERIFY_END,
+    FSM_STATE_SUCCESS,
+    FSM_STATE_FAILURE
+} FSMState;
+
+// Visão do payload de um quadro: aponta para a entrada de parseBytes
+// quando o quadro chegou inteiro na mesma chamada, ou para 'payload'
+typedef struct {
+    const uint8_t *ptr;
+    size_t len;
+} FrameView;
+
+// Estrutura que representa a FSM
+typedef struct {
+    FSMState state;
+    uint8_t length;
+    uint8_t payload[256];                // Reserva para quadros que atravessam blocos
+    FrameView view;                      // Payload do último quadro (válida no FrameCallback)
+    uint16_t checksum;                   // Checksum recebido
+    uint8_t index;
+    ChecksumAlgorithm checksumAlgorithm; // Verificação do quadro (frame-checksum.h)
+    uint16_t computed;                   // Cálculo incremental sobre length + payload
+    uint8_t checksumBytes;               // Bytes do checksum já lidos
+    bool resync;                         // Varrer de novo os bytes de um quadro rejeitado
+    bool recovering;                     // O STX atual foi achado nessa nova varredura
+    size_t bytesDiscarded;               // Bytes que não fizeram parte de quadro válido
+    size_t framesRecovered;              // Quadros válidos achados dentro de quadros rejeitados
+} StateMachine;
+
+// Definição do tipo de função para os manipuladores de estado
+typedef bool (*StateFunction)(StateMachine *sm, uint8_t input);
+
+// Função chamada a cada quadro completo (payload em sm->view)
+typedef void (*FrameCallback)(const StateMachine *sm, void *context);
+
+// Função para inicializar ou resetar a FSM
+static inline void initializeStateMachine(StateMachine *sm) {
+    sm->state = FSM_STATE_INIT;
+    sm->length = 0;
+    sm->checksum = 0;
+    sm->index = 0;
+    sm->view.ptr = sm->payload;
+    sm->view.len = 0;
+    sm->checksumAlgorithm = CHECKSUM_NONE;
+    sm->computed = 0;
+    sm->checksumBytes = 0;
+    sm->resync = false;
+    sm->recovering = false;
+    sm->bytesDiscarded = 0;
+    sm->framesRecovered = 0;
+}
+
+// Função para escolher o algoritmo de verificação (padrão: CHECKSUM_NONE)
+static inline void setChecksumAlgorithm(StateMachine *sm, ChecksumAlgorithm algorithm) {
+    sm->checksumAlgorithm = algorithm;
+}
+
+// Função para ligar a ressincronização em parseBytes (padrão: desligada).
+// Sem ela, um quadro rejeitado (ETX errado ou checksum que não confere) é
+// descartado inteiro. Com ela, só o STX falso é descartado e os bytes
+// seguintes são varridos de novo em busca do próximo STX.
+static inline void setResync(StateMachine *sm, bool enabled) {
+    sm->resync = enabled;
+}
+
+// Função para manipular o estado inicial (aguardando STX)
+static inline bool stateInit(StateMachine *sm, uint8_t input) {
+    if (input == FSM_STX) {
+        sm->index = 0;
+        sm->computed = checksumInit(sm->checksumAlgorithm);
+        sm->recovering = false;
+        sm->state = FSM_STATE_GET_LENGTH;
+    } else {
+        sm->bytesDiscarded++;
+    }
+    return false;
+}
+
+// Função para obter o comprimento do payload
+static inline bool stateGetLength(StateMachine *sm, uint8_t input) {
+    sm->length = input;
+    sm->computed = checksumUpdateByte(sm->checksumAlgorithm, sm->computed, input);
+    sm->checksum = 0;
+    sm->checksumBytes = 0;
+    sm->view.ptr = sm->payload;
+    sm->view.len = input;
+    sm->state = input ? FSM_STATE_GET_PAYLOAD : FSM_STATE_GET_CHECKSUM;
+    return false;
+}
+
+// Função para obter o payload
+static inline bool stateGetPayload(StateMachine *sm, uint8_t input) {
+    sm->payload[sm->index++] = input;
+    sm->computed = checksumUpdateByte(sm->checksumAlgorithm, sm->computed, input);
+    if (sm->index == sm->length) {
+        sm->state = FSM_STATE_GET_CHECKSUM;
+    }
+    return false;
+}
+
+// Função para obter o checksum (2 bytes no CRC-16, mais significativo primeiro)
+static inline bool stateGetChecksum(StateMachine *sm, uint8_t input) {
+    sm->checksum = (uint16_t)((sm->checksum << 8) | input);
+    if (++sm->checksumBytes == checksumSize(sm->checksumAlgorithm)) {
+        sm->state = FSM_STATE_VERIFY_END;
+    }
+    return false;
+}
+
+// Função para verificar o fim da mensagem e o checksum
+static inline bool stateVerifyEnd(StateMachine *sm, uint8_t input) {
+    if (input == FSM_ETX && checksumMatches(sm->checksumAlgorithm, sm->computed, sm->checksum)) {
+        sm->framesRecovered += sm->recovering;
+        sm->state = FSM_STATE_SUCCESS;
+        return true;
+    } else {
+        // STX, length, payload, checksum e o byte no lugar do ETX
+        sm->bytesDiscarded += (size_t)sm->length + checksumSize(sm->checksumAlgorithm) + 3;
+        sm->state = FSM_STATE_FAILURE;
+    }
+    return false;
+}
+
+// Tabela que mapeia cada estado à sua respectiva função manipuladora
+static StateFunction const stateFunctions[] = {
+    stateInit,
+    stateGetLength,
+    stateGetPayload,
+    stateGetChecksum,
+    stateVerifyEnd
+};
+
+// Função para processar a entrada e avançar a FSM.
+// Depois de SUCCESS/FAILURE a FSM volta ao estado inicial e o mesmo byte
+// já é processado nele (um STX logo após o ETX não se perde).
+static inline bool processInput(StateMachine *sm, uint8_t input) {
+    if (sm->state >= FSM_STATE_SUCCESS) {
+        sm->state = FSM_STATE_INIT;
+    }
+    return stateFunctions[sm->state](sm, input);
+}
+
+// Varre 'buf' a partir do estado atual; os bytes antes de 'rescanEnd' já
+// são uma nova varredura (ressincronização). Usada por parseBytes.
+static inline size_t parseSegment(StateMachine *sm, const uint8_t *buf, size_t len,
+                                  FrameCallback onFrame, void *context, size_t rescanEnd) {
+    size_t i = 0, frames = 0;
+    size_t start = SIZE_MAX;  // Posição do STX do quadro atual neste trecho
+    while (i < len) {
+        if (sm->state >= FSM_STATE_SUCCESS) {
+            sm->state = FSM_STATE_INIT;
+        }
+        if (sm->state == FSM_STATE_INIT) {
+            const uint8_t *skipped = buf + rescanEnd;
+            const uint8_t *stx = stxFindFrame(buf + i, buf + len, checksumSize(sm->checksumAlgorithm),
+                                              sm->resync, &skipped);
+            rescanEnd = (size_t)(skipped - buf);  // Candidatos pulados contam como rejeitados
+            if (stx == NULL) {
+                sm->bytesDiscarded += len - i;
+                break;
+            }
+            start = (size_t)(stx - buf);
+            sm->bytesDiscarded += start - i;
+            i = start + 1;
+            sm->index = 0;
+            sm->computed = checksumInit(sm->checksumAlgorithm);
+            sm->recovering = start < rescanEnd;
+            sm->state = FSM_STATE_GET_LENGTH;
+        } else if (sm->state == FSM_STATE_GET_PAYLOAD) {
+            size_t n = (size_t)(sm->length - sm->index);
+            if (sm->index == 0 && n <= len - i) {
+                sm->view.ptr = buf + i;  // Sem cópia
+            } else {
+                if (n > len - i) {
+                    n = len - i;
+                }
+                memcpy(&sm->payload[sm->index], buf + i, n);
+            }
+            sm->computed = checksumUpdate(sm->checksumAlgorithm, sm->computed, buf + i, n);
+            sm->index += (uint8_t)n;
+            i += n;
+            if (sm->index == sm->length) {
+                sm->state = FSM_STATE_GET_CHECKSUM;
+            }
+        } else if (stateFunctions[sm->state](sm, buf[i++])) {
+            frames++;
+            if (onFrame) {
+                onFrame(sm, context);
+            }
+        } else if (sm->state == FSM_STATE_FAILURE && sm->resync) {
+            // Só o STX falso fica descartado; o resto é varrido de novo
+            size_t k = checksumSize(sm->checksumAlgorithm);
+            size_t consumed = (size_t)sm->length + k + 2;  // Após o STX
+            sm->bytesDiscarded -= consumed;
+            if (rescanEnd < i) {
+                rescanEnd = i;
+            }
+            if (start != SIZE_MAX) {
+                i = start + 1;  // Quadro inteiro neste trecho: basta voltar
+            } else {
+                // O quadro começou em chamada anterior: a parte que veio antes
+                // de 'buf' é refeita a partir do estado (length, payload e
+                // checksum) e varrida antes de buf[0]
+                uint8_t earlier[1 + 255 + 2];
+                size_t n = consumed - i;
+                earlier[0] = sm->length;
+                memcpy(&earlier[1], sm->view.ptr, sm->length);
+                for (size_t j = 0; j < k; j++) {
+                    earlier[1 + sm->length + j] = (uint8_t)(sm->checksum >> (8 * (k - 1 - j)));
+                }
+                sm->state = FSM_STATE_INIT;
+                frames += parseSegment(sm, earlier, n, onFrame, context, n);
+                i = 0;
+            }
+            start = SIZE_MAX;
+        }
+    }
+    if (sm->view.ptr != sm->payload &&
+        (sm->state == FSM_STATE_GET_CHECKSUM || sm->state == FSM_STATE_VERIFY_END)) {
+        memcpy(sm->payload, sm->view.ptr, sm->view.len);
+        sm->view.ptr = sm->payload;
+    }
+    return frames;
+}
+
+// Função para processar um bloco de bytes de uma vez.
+// No estado inicial procura o STX com stxFindFrame (stx-scan.h: SSE2/AVX2
+// no x86), que já confere o byte na posição do ETX e pula os candidatos
+// que a FSM rejeitaria, com o mesmo resultado (quadros e contadores) de
+// passá-los por ela. No estado de payload, se o
+// payload está inteiro no bloco, sm->view aponta direto para ele, sem
+// cópia; só um quadro que atravessa o fim do bloco é copiado (um memcpy
+// por trecho) para 'payload'. O checksum é atualizado sobre o trecho
+// inteiro, sem a chamada indireta por byte. Chama onFrame (se não for
+// NULL) a cada quadro completo e retorna quantos quadros foram completados.
+// O bloco pode terminar no meio de um quadro: o estado é mantido para a
+// próxima chamada, e um payload que ainda apontava para 'buf' é copiado
+// para 'payload', pois 'buf' pode ser reutilizado por quem chama.
+// Com setResync, um quadro rejeitado volta a ser varrido a partir do byte
+// seguinte ao STX falso, mesmo que tenha começado em uma chamada anterior.
+static inline size_t parseBytes(StateMachine *sm, const uint8_t *buf, size_t len,
+                                FrameCallback onFrame, void *context) {
+    return parseSegment(sm, buf, len, onFrame, context, 0);
+}
+
+#endif // FSM_PONTEIRO_TABELA_H
@@ -0,0 +1,109 @@
+// Benchmark: os três motores gerados da mesma descrição (frame-fsm.h) no
+// mesmo fluxo. Como a máquina é idêntica, a diferença é só o despacho:
+//   Switch   switch sobre o estado a cada byte
+//   Table    chamada indireta por frameFsmHandlers[] a cada byte
+//   Goto     goto computado direto para o rótulo do próximo estado
+//
+// As linhas do relatório também são geradas por FRAME_FSM_ENGINES: um
+// motor novo na lista entra no benchmark sem mudar este arquivo.
+//
+// O fluxo é o mesmo do bench-parse.c (payload de 0 a 255 bytes, um pouco
+// de ruído entre os quadros), entregue em blocos de CHUNK bytes.
+//
+// Compilação:  gcc -O2 bench-dispatch.c -o bench-dispatch
+// Uso:         ./bench-dispatch [MB] [crc]   (crc: usa CRC-16 nos quadros)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "frame-fsm.h"
+
+#define CHUNK 4096
+#define REPEAT 3
+
+static uint8_t *stream;
+static size_t stream_len;
+static size_t frames_generated;
+static ChecksumAlgorithm algorithm = CHECKSUM_NONE;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void generateStream(size_t megabytes) {
+    size_t limit = megabytes * 1000000;
+    stream = malloc(limit + 512);
+    unsigned seed = 7;
+    size_t i = 0;
+    while (i < limit) {
+        seed = seed * 1103515245u + 12345u;
+        size_t noise = (seed >> 16) % 4;
+        for (size_t k = 0; k < noise; k++) {
+            stream[i++] = 0x55;
+        }
+        seed = seed * 1103515245u + 12345u;
+        uint8_t n = (uint8_t)(seed >> 16);
+        size_t start = i;
+        stream[i++] = FRAME_FSM_STX;
+        stream[i++] = n;
+        for (int k = 0; k < n; k++) {
+            seed = seed * 1103515245u + 12345u;
+            stream[i++] = (uint8_t)(seed >> 16);
+        }
+        uint16_t c = checksumUpdate(algorithm, checksumInit(algorithm), &stream[start + 1], (size_t)n + 1);
+        if (checksumSize(algorithm) == 2) {
+            stream[i++] = (uint8_t)(c >> 8);
+        }
+        stream[i++] = (uint8_t)c;
+        stream[i++] = FRAME_FSM_ETX;
+        frames_generated++;
+    }
+    stream_len = i;
+}
+
+static void sumFrame(const FrameFsm *f, void *context) {
+    *(unsigned long *)context += f->length + f->payload[0];
+}
+
+// Melhor de REPEAT execuções de cada motor, a máquina partindo do zero
+#define MEASURE(engine)                                                                 \
+    do {                                                                                \
+        double best = 1e30;                                                             \
+        size_t frames = 0;                                                              \
+        unsigned long check = 0;                                                        \
+        for (int rep = 0; rep < REPEAT; rep++) {                                        \
+            FrameFsm f;                                                                 \
+            frameFsmInit(&f);                                                           \
+            frameFsmSetChecksum(&f, algorithm);                                         \
+            frames = 0;                                                                 \
+            check = 0;                                                                  \
+            double start = now();                                                       \
+            for (size_t b = 0; b < stream_len; b += CHUNK) {                            \
+                size_t n = b + CHUNK < stream_len ? CHUNK : stream_len - b;             \
+                frames += frameFsmRun##engine(&f, stream + b, n, sumFrame, &check);     \
+            }                                                                           \
+            double seconds = now() - start;                                             \
+            if (seconds < best) best = seconds;                                         \
+        }                                                                               \
+        printf("%-8s %8.1f MB/s  %6.2f ns/byte  quadros %zu/%zu  verificação %lu\n",    \
+               #engine, stream_len / best / 1e6, best * 1e9 / stream_len, frames,       \
+               frames_generated, check);                                                \
+    } while (0);
+
+int main(int argc, char **argv) {
+    size_t megabytes = 128;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    if (argc > 2 && strcmp(argv[2], "crc") == 0) algorithm = CHECKSUM_CRC16_CCITT;
+    generateStream(megabytes);
+    printf("fluxo=%zu bytes quadros=%zu bloco=%d checksum=%s\n", stream_len, frames_generated, CHUNK,
+           algorithm == CHECKSUM_NONE ? "nenhum" : "CRC-16");
+
+    FRAME_FSM_ENGINES(MEASURE)
+
+    free(stream);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Benchmark: as três máquinas do quadro, byte a byte, no mesmo fluxo:
+//   switch      processarByte (ATV_02/FSMswitchCase.h)
+//   ponteiros   processInput, stateFunctions[] (FSMponteiroTabela.h)
+//   dfa         dfaStep, tabela [estado][classe] (dfa-parser.h)
+//   dfa-bloco   dfaParseBytes: o mesmo autômato com o estado em registradores
+//
+// O fluxo é o mesmo do bench-parse.c: quadros com payload de tamanho
+// aleatório (0 a 255) e um pouco de ruído sem STX entre eles. Cada motor
+// fica em uma função noinline (run*) para que o tamanho de código possa ser
+// lido no objeto:
+//
+//   gcc -O2 -c bench-engines.c && nm -S --size-sort bench-engines.o | grep -Ei 'run|state|dfa'
+//
+// No Cortex-M0+ o mesmo vale com o compilador cruzado (o main não roda lá,
+// só o tamanho interessa):
+//
+//   arm-none-eabi-gcc -mcpu=cortex-m0plus -mthumb -Os -c bench-engines.c
+//   arm-none-eabi-nm -S --size-sort bench-engines.o | grep -Ei 'run|state|dfa'
+//
+// Compilação:  gcc -O2 bench-engines.c -o bench-engines
+// Uso:         ./bench-engines [MB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../ATV_02/FSMswitchCase.h"
+#include "FSMponteiroTabela.h"
+#include "dfa-parser.h"
+
+static uint8_t *stream;
+static size_t stream_len;
+static size_t frames_generated;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void generateStream(size_t megabytes) {
+    size_t limit = megabytes * 1000000;
+    stream = malloc(limit + 512);
+    unsigned seed = 7;
+    size_t i = 0;
+    while (i < limit) {
+        seed = seed * 1103515245u + 12345u;
+        size_t noise = (seed >> 16) % 4;
+        for (size_t k = 0; k < noise; k++) {
+            stream[i++] = 0x55;
+        }
+        seed = seed * 1103515245u + 12345u;
+        uint8_t n = (uint8_t)(seed >> 16);
+        stream[i++] = FSM_STX;
+        stream[i++] = n;
+        for (int k = 0; k < n; k++) {
+            seed = seed * 1103515245u + 12345u;
+            stream[i++] = (uint8_t)(seed >> 16);
+        }
+        stream[i++] = 0;
+        stream[i++] = FSM_ETX;
+        frames_generated++;
+    }
+    stream_len = i;
+}
+
+__attribute__((noinline)) size_t runSwitch(MaquinaEstados *m, const uint8_t *buf, size_t len, unsigned long *check) {
+    size_t frames = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (processarByte(m, buf[i])) {
+            frames++;
+            *check += m->tamanho + m->dados[0];
+        }
+    }
+    return frames;
+}
+
+__attribute__((noinline)) size_t runTable(StateMachine *sm, const uint8_t *buf, size_t len, unsigned long *check) {
+    size_t frames = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (processInput(sm, buf[i])) {
+            frames++;
+            *check += sm->length + sm->payload[0];
+        }
+    }
+    return frames;
+}
+
+__attribute__((noinline)) size_t runDfa(DfaParser *p, const uint8_t *buf, size_t len, unsigned long *check) {
+    size_t frames = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (dfaStep(p, buf[i])) {
+            frames++;
+            *check += p->r.length + p->payload[0];
+        }
+    }
+    return frames;
+}
+
+static void sumDfaFrame(const DfaParser *p, void *context) {
+    *(unsigned long *)context += p->r.length + p->payload[0];
+}
+
+__attribute__((noinline)) size_t runDfaBulk(DfaParser *p, const uint8_t *buf, size_t len, unsigned long *check) {
+    return dfaParseBytes(p, buf, len, sumDfaFrame, check);
+}
+
+static void report(const char *name, double seconds, size_t frames, unsigned long check) {
+    printf("%-10s %8.1f MB/s  %6.2f ns/byte  quadros %zu/%zu  verificação %lu\n", name,
+           stream_len / seconds / 1e6, seconds * 1e9 / stream_len, frames, frames_generated, check);
+}
+
+// Melhor de REPEAT execuções de cada motor (a máquina parte do zero em cada uma)
+#define REPEAT 3
+#define MEASURE(name, type, init, run)                                  \
+    do {                                                                \
+        double best = 1e30;                                             \
+        size_t frames = 0;                                              \
+        unsigned long check = 0;                                        \
+        for (int rep = 0; rep < REPEAT; rep++) {                        \
+            type engine;                                                \
+            init(&engine);                                              \
+            check = 0;                                                  \
+            double start = now();                                       \
+            frames = run(&engine, stream, stream_len, &check);          \
+            double seconds = now() - start;                             \
+            if (seconds < best) best = seconds;                         \
+        }                                                               \
+        report(name, best, frames, check);                              \
+    } while (0)
+
+int main(int argc, char **argv) {
+    size_t megabytes = 128;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    generateStream(megabytes);
+    printf("fluxo=%zu bytes quadros=%zu\n", stream_len, frames_generated);
+
+    MEASURE("switch", MaquinaEstados, inicializarMaquina, runSwitch);
+    MEASURE("ponteiros", StateMachine, initializeStateMachine, runTable);
+    MEASURE("dfa", DfaParser, initializeDfaParser, runDfa);
+    MEASURE("dfa-bloco", DfaParser, initializeDfaParser, runDfaBulk);
+
+    printf("tabelas do dfa: %zu bytes (classes) + %zu bytes (transições)\n",
+           sizeof(dfaByteClass), sizeof(dfaTransitions));
+    free(stream);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Benchmark: processInput (uma chamada indireta por byte) contra
+// parseBytes (memchr até o STX + visão sem cópia do payload) em um fluxo
+// sintético grande.
+//
+// O fluxo tem quadros com payload de tamanho aleatório (0 a 255) e, entre
+// eles, um pouco de ruído sem STX. É entregue em blocos de CHUNK bytes,
+// como chegaria de uma leitura de UART/socket.
+//
+// Compilação:  gcc -O2 bench-parse.c -o bench-parse
+// Uso:         ./bench-parse [MB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FSMponteiroTabela.h"
+
+#define CHUNK 4096
+
+static uint8_t *stream;
+static size_t stream_len;
+static size_t frames_generated;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void generateStream(size_t megabytes) {
+    size_t limit = megabytes * 1000000;
+    stream = malloc(limit + 512);
+    unsigned seed = 7;
+    size_t i = 0;
+    while (i < limit) {
+        seed = seed * 1103515245u + 12345u;
+        size_t noise = (seed >> 16) % 4;
+        for (size_t k = 0; k < noise; k++) {
+            stream[i++] = 0x55;
+        }
+        seed = seed * 1103515245u + 12345u;
+        uint8_t n = (uint8_t)(seed >> 16);
+        stream[i++] = FSM_STX;
+        stream[i++] = n;
+        for (int k = 0; k < n; k++) {
+            seed = seed * 1103515245u + 12345u;
+            stream[i++] = (uint8_t)(seed >> 16);
+        }
+        stream[i++] = 0;
+        stream[i++] = FSM_ETX;
+        frames_generated++;
+    }
+    stream_len = i;
+}
+
+static void sumFrame(const StateMachine *sm, void *context) {
+    *(unsigned long *)context += sm->view.len + (sm->view.len ? sm->view.ptr[0] : 0);
+}
+
+static void report(const char *name, double seconds, size_t frames, unsigned long check) {
+    printf("%-12s %8.1f MB/s  quadros %zu/%zu  verificação %lu\n", name,
+           stream_len / seconds / 1e6, frames, frames_generated, check);
+}
+
+static void measurePerByte(void) {
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    size_t frames = 0;
+    unsigned long check = 0;
+    double start = now();
+    for (size_t b = 0; b < stream_len; b += CHUNK) {
+        size_t end = b + CHUNK < stream_len ? b + CHUNK : stream_len;
+        for (size_t i = b; i < end; i++) {
+            if (processInput(&sm, stream[i])) {
+                frames++;
+                sumFrame(&sm, &check);
+            }
+        }
+    }
+    report("processInput", now() - start, frames, check);
+}
+
+static void measureBulk(void) {
+    StateMachine sm;
+    initializeStateMachine(&sm);
+    size_t frames = 0;
+    unsigned long check = 0;
+    double start = now();
+    for (size_t b = 0; b < stream_len; b += CHUNK) {
+        size_t n = b + CHUNK < stream_len ? CHUNK : stream_len - b;
+        frames += parseBytes(&sm, stream + b, n, sumFrame, &check);
+    }
+    report("parseBytes", now() - start, frames, check);
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = 256;
+    if (argc > 1) megabytes = (size_t)atol(argv[1]);
+    generateStream(megabytes);
+    printf("fluxo=%zu bytes quadros=%zu bloco=%d\n", stream_len, frames_generated, CHUNK);
+    measurePerByte();
+    measureBulk();
+    free(stream);
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Terceira implementação da máquina do quadro STX | LENGTH | PAYLOAD |
+// CHECKSUM | ETX: autômato (DFA) com tabela de transições
+// [estado][classe do byte].
+//
+// Cada byte vira uma classe (dfaByteClass) e a transição sai de uma única
+// consulta em dfaTransitions, que traz o próximo estado e a ação. Não há
+// switch sobre o estado nem chamada indireta por byte: o grafo inteiro está
+// nas duas tabelas (256 + 15 bytes). A contagem do length, do payload e dos
+// bytes de checksum fica nas ações, que ajustam o estado quando o contador
+// chega ao fim; a ação de payload, a mais frequente, é testada antes do
+// switch das demais.
+//
+// Mesmo comportamento de FSMponteiroTabela.h: depois de um quadro aceito ou
+// rejeitado o byte seguinte já é tratado como no estado inicial, e o byte
+// no lugar do ETX é consumido.
+
+#ifndef DFA_PARSER_H
+#define DFA_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../ATV_02/frame-checksum.h"
+
+#define DFA_STX 0x02
+#define DFA_ETX 0x03
+
+// Estados do autômato
+typedef enum {
+    DFA_IDLE,
+    DFA_LENGTH,
+    DFA_PAYLOAD,
+    DFA_CHECKSUM,
+    DFA_END,
+    DFA_STATES
+} DfaState;
+
+// Classes de byte: só STX e ETX mudam o grafo, o resto é igual
+typedef enum {
+    DFA_CLASS_OTHER,
+    DFA_CLASS_STX,
+    DFA_CLASS_ETX,
+    DFA_CLASSES
+} DfaByteClass;
+
+// Ações executadas na transição
+typedef enum {
+    DFA_ACT_NONE,
+    DFA_ACT_START,     // STX: zera índice e checksum
+    DFA_ACT_LENGTH,    // Guarda o length; length 0 pula para DFA_CHECKSUM
+    DFA_ACT_PAYLOAD,   // Guarda o byte; último byte passa para DFA_CHECKSUM
+    DFA_ACT_CHECKSUM,  // Acumula o checksum; último byte passa para DFA_END
+    DFA_ACT_ACCEPT,    // ETX: aceita se o checksum confere
+    DFA_ACT_REJECT     // Qualquer outro byte no lugar do ETX
+} DfaAction;
+
+// Entrada da tabela: próximo estado nos 4 bits baixos, ação nos altos
+#define DFA_ENTRY(next, action) ((uint8_t)((next) | ((action) << 4)))
+
+static const uint8_t dfaByteClass[256] = {
+    [DFA_STX] = DFA_CLASS_STX,
+    [DFA_ETX] = DFA_CLASS_ETX,
+};
+
+static const uint8_t dfaTransitions[DFA_STATES][DFA_CLASSES] = {
+    //                OTHER                                    STX                                      ETX
+    [DFA_IDLE]     = {DFA_ENTRY(DFA_IDLE, DFA_ACT_NONE),        DFA_ENTRY(DFA_LENGTH, DFA_ACT_START),     DFA_ENTRY(DFA_IDLE, DFA_ACT_NONE)},
+    [DFA_LENGTH]   = {DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_LENGTH),   DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_LENGTH),   DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_LENGTH)},
+    [DFA_PAYLOAD]  = {DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_PAYLOAD),  DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_PAYLOAD),  DFA_ENTRY(DFA_PAYLOAD, DFA_ACT_PAYLOAD)},
+    [DFA_CHECKSUM] = {DFA_ENTRY(DFA_CHECKSUM, DFA_ACT_CHECKSUM), DFA_ENTRY(DFA_CHECKSUM, DFA_ACT_CHECKSUM), DFA_ENTRY(DFA_CHECKSUM, DFA_ACT_CHECKSUM)},
+    [DFA_END]      = {DFA_ENTRY(DFA_IDLE, DFA_ACT_REJECT),      DFA_ENTRY(DFA_IDLE, DFA_ACT_REJECT),      DFA_ENTRY(DFA_IDLE, DFA_ACT_ACCEPT)},
+};
+
+// Estado escalar do autômato, separado do payload para que dfaParseBytes
+// possa mantê-lo em registradores (escritas no payload são uint8_t e, pela
+// regra de aliasing, obrigariam a recarregar campos da estrutura)
+typedef struct {
+    uint8_t state;                       // DfaState
+    uint8_t length;
+    uint8_t index;
+    uint8_t checksumBytes;               // Bytes do checksum já lidos
+    uint16_t checksum;                   // Checksum recebido
+    uint16_t computed;                   // Cálculo incremental sobre length + payload
+} DfaRegisters;
+
+// Estrutura do parser
+typedef struct {
+    DfaRegisters r;
+    ChecksumAlgorithm checksumAlgorithm; // Verificação do quadro (frame-checksum.h)
+    bool rejected;                       // Último quadro terminou rejeitado
+    uint8_t payload[256];
+} DfaParser;
+
+// Função chamada a cada quadro completo (payload em p->payload, tamanho em p->r.length)
+typedef void (*DfaFrameCallback)(const DfaParser *p, void *context);
+
+// Função para inicializar ou resetar o parser
+static inline void initializeDfaParser(DfaParser *p) {
+    p->r.state = DFA_IDLE;
+    p->r.length = 0;
+    p->r.index = 0;
+    p->r.checksumBytes = 0;
+    p->r.checksum = 0;
+    p->r.computed = 0;
+    p->checksumAlgorithm = CHECKSUM_NONE;
+    p->rejected = false;
+}
+
+// Função para escolher o algoritmo de verificação (padrão: CHECKSUM_NONE)
+static inline void setDfaChecksumAlgorithm(DfaParser *p, ChecksumAlgorithm algorithm) {
+    p->checksumAlgorithm = algorithm;
+}
+
+// Transição de um byte sobre o estado 'r'. Retorna 1 quando um quadro é
+// aceito, -1 quando é rejeitado e 0 nos demais bytes.
+static inline int dfaAdvance(DfaRegisters *r, uint8_t *payload, ChecksumAlgorithm alg, uint8_t input) {
+    uint8_t entry = dfaTransitions[r->state][dfaByteClass[input]];
+    uint8_t action = entry >> 4;
+    r->state = entry & 0x0F;
+    // Caminho comum (bytes de payload) testado antes do switch: um desvio
+    // quase sempre acertado em vez do salto indireto da tabela do switch
+    if (action == DFA_ACT_PAYLOAD) {
+        payload[r->index++] = input;
+        r->computed = checksumUpdateByte(alg, r->computed, input);
+        if (r->index == r->length) {
+            r->state = DFA_CHECKSUM;
+        }
+        return 0;
+    }
+    switch (action) {
+        case DFA_ACT_NONE:
+            break;
+        case DFA_ACT_START:
+            r->index = 0;
+            r->computed = checksumInit(alg);
+            break;
+        case DFA_ACT_LENGTH:
+            r->length = input;
+            r->computed = checksumUpdateByte(alg, r->computed, input);
+            r->checksum = 0;
+            r->checksumBytes = 0;
+            if (input == 0) {
+                r->state = DFA_CHECKSUM;
+            }
+            break;
+        case DFA_ACT_CHECKSUM:
+            r->checksum = (uint16_t)((r->checksum << 8) | input);
+            if (++r->checksumBytes == checksumSize(alg)) {
+                r->state = DFA_END;
+            }
+            break;
+        case DFA_ACT_ACCEPT:
+            return checksumMatches(alg, r->computed, r->checksum) ? 1 : -1;
+        case DFA_ACT_REJECT:
+            return -1;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// Função para processar um byte; retorna true quando um quadro é aceito
+static inline bool dfaStep(DfaParser *p, uint8_t input) {
+    int result = dfaAdvance(&p->r, p->payload, p->checksumAlgorithm, input);
+    if (result != 0) {
+        p->rejected = result < 0;
+    }
+    return result > 0;
+}
+
+// Função para processar um bloco de bytes, um byte por vez pela tabela,
+// com o estado escalar em variáveis locais (gravado de volta antes de cada
+// onFrame e no fim). Chama onFrame (se não for NULL) a cada quadro aceito e
+// retorna quantos quadros foram aceitos. O bloco pode terminar no meio de
+// um quadro.
+static inline size_t dfaParseBytes(DfaParser *p, const uint8_t *buf, size_t len,
+                                   DfaFrameCallback onFrame, void *context) {
+    DfaRegisters r = p->r;
+    ChecksumAlgorithm alg = p->checksumAlgorithm;
+    size_t frames = 0;
+    for (size_t i = 0; i < len; i++) {
+        int result = dfaAdvance(&r, p->payload, alg, buf[i]);
+        if (result != 0) {
+            p->rejected = result < 0;
+            if (result > 0) {
+                frames++;
+                if (onFrame) {
+                    p->r = r;
+                    onFrame(p, context);
+                }
+            }
+        }
+    }
+    p->r = r;
+    return frames;
+}
+
+#endif // DFA_PARSER_H
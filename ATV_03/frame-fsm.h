@@ -0,0 +1,285 @@
+// Descrição única (X-macro) da máquina do quadro STX | LENGTH | PAYLOAD |
+// CHECKSUM | ETX e os três motores gerados a partir dela:
+//
+//   frameFsmRunSwitch   switch sobre o estado
+//   frameFsmRunTable    tabela de ponteiros de função (como stateFunctions[])
+//   frameFsmRunGoto     goto computado com rótulos como valores do GCC (o
+//                       mesmo recurso do ATV_04/lc-addrlabels.h)
+//
+// A máquina inteira está em FRAME_FSM_STATES e FRAME_FSM_TRANSITIONS. Cada
+// transição é T(origem, guarda, ação, destino); as transições de um estado
+// são testadas na ordem em que aparecem e a primeira guarda verdadeira
+// vence. Guardas são frameGuard_<nome>(f, input) e ações são
+// frameAction_<nome>(f, input). Mudar a máquina é mudar essa lista: os três
+// motores continuam com o mesmo comportamento, inclusive depois de um
+// quadro aceito ou rejeitado (o byte seguinte já é tratado em IDLE).
+
+#ifndef FRAME_FSM_H
+#define FRAME_FSM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../ATV_02/frame-checksum.h"
+
+#define FRAME_FSM_STX 0x02
+#define FRAME_FSM_ETX 0x03
+
+// ---- Descrição da máquina ----
+
+#define FRAME_FSM_STATES(X) \
+    X(IDLE)                 \
+    X(LENGTH)               \
+    X(PAYLOAD)              \
+    X(CHECKSUM)             \
+    X(END)
+
+#define FRAME_FSM_TRANSITIONS(T)                       \
+    T(IDLE,     isStx,        start,    LENGTH)        \
+    T(IDLE,     always,       discard,  IDLE)          \
+    T(LENGTH,   isZero,       length,   CHECKSUM)      \
+    T(LENGTH,   always,       length,   PAYLOAD)       \
+    T(PAYLOAD,  lastPayload,  payload,  CHECKSUM)      \
+    T(PAYLOAD,  always,       payload,  PAYLOAD)       \
+    T(CHECKSUM, lastChecksum, checksum, END)           \
+    T(CHECKSUM, always,       checksum, CHECKSUM)      \
+    T(END,      frameOk,      accept,   IDLE)          \
+    T(END,      always,       reject,   IDLE)
+
+// Motores gerados (usado pelo benchmark e pelos testes para percorrer todos)
+#define FRAME_FSM_ENGINES(E) \
+    E(Switch)                \
+    E(Table)                 \
+    E(Goto)
+
+// ---- Tipos ----
+
+#define FRAME_FSM_ENUM(name) FRAME_FSM_##name,
+typedef enum {
+    FRAME_FSM_STATES(FRAME_FSM_ENUM)
+    FRAME_FSM_STATE_COUNT
+} FrameFsmState;
+#undef FRAME_FSM_ENUM
+
+typedef struct FrameFsm FrameFsm;
+
+// Função chamada a cada quadro aceito (payload em f->payload, f->length bytes)
+typedef void (*FrameFsmCallback)(const FrameFsm *f, void *context);
+
+struct FrameFsm {
+    uint8_t state;                       // FrameFsmState
+    uint8_t length;
+    uint8_t index;
+    uint8_t checksumBytes;               // Bytes do checksum já lidos
+    uint16_t checksum;                   // Checksum recebido
+    uint16_t computed;                   // Cálculo incremental sobre length + payload
+    ChecksumAlgorithm checksumAlgorithm; // Verificação do quadro (frame-checksum.h)
+    size_t frames;                       // Quadros aceitos
+    size_t rejected;                     // Quadros rejeitados (ETX ou checksum)
+    FrameFsmCallback onFrame;            // Definidos a cada chamada de frameFsmRun*
+    void *context;
+    uint8_t payload[256];
+};
+
+// Função para inicializar ou resetar a máquina
+static inline void frameFsmInit(FrameFsm *f) {
+    f->state = FRAME_FSM_IDLE;
+    f->length = 0;
+    f->index = 0;
+    f->checksumBytes = 0;
+    f->checksum = 0;
+    f->computed = 0;
+    f->checksumAlgorithm = CHECKSUM_NONE;
+    f->frames = 0;
+    f->rejected = 0;
+    f->onFrame = NULL;
+    f->context = NULL;
+}
+
+// Função para escolher o algoritmo de verificação (padrão: CHECKSUM_NONE)
+static inline void frameFsmSetChecksum(FrameFsm *f, ChecksumAlgorithm algorithm) {
+    f->checksumAlgorithm = algorithm;
+}
+
+// ---- Guardas ----
+
+static inline bool frameGuard_always(const FrameFsm *f, uint8_t input) {
+    (void)f;
+    (void)input;
+    return true;
+}
+
+static inline bool frameGuard_isStx(const FrameFsm *f, uint8_t input) {
+    (void)f;
+    return input == FRAME_FSM_STX;
+}
+
+static inline bool frameGuard_isZero(const FrameFsm *f, uint8_t input) {
+    (void)f;
+    return input == 0;
+}
+
+static inline bool frameGuard_lastPayload(const FrameFsm *f, uint8_t input) {
+    (void)input;
+    return f->index + 1 == f->length;
+}
+
+static inline bool frameGuard_lastChecksum(const FrameFsm *f, uint8_t input) {
+    (void)input;
+    return f->checksumBytes + 1u == checksumSize(f->checksumAlgorithm);
+}
+
+static inline bool frameGuard_frameOk(const FrameFsm *f, uint8_t input) {
+    return input == FRAME_FSM_ETX && checksumMatches(f->checksumAlgorithm, f->computed, f->checksum);
+}
+
+// ---- Ações ----
+
+static inline void frameAction_discard(FrameFsm *f, uint8_t input) {
+    (void)f;
+    (void)input;
+}
+
+static inline void frameAction_start(FrameFsm *f, uint8_t input) {
+    (void)input;
+    f->index = 0;
+    f->computed = checksumInit(f->checksumAlgorithm);
+}
+
+static inline void frameAction_length(FrameFsm *f, uint8_t input) {
+    f->length = input;
+    f->computed = checksumUpdateByte(f->checksumAlgorithm, f->computed, input);
+    f->checksum = 0;
+    f->checksumBytes = 0;
+}
+
+static inline void frameAction_payload(FrameFsm *f, uint8_t input) {
+    f->payload[f->index++] = input;
+    f->computed = checksumUpdateByte(f->checksumAlgorithm, f->computed, input);
+}
+
+static inline void frameAction_checksum(FrameFsm *f, uint8_t input) {
+    f->checksum = (uint16_t)((f->checksum << 8) | input);
+    f->checksumBytes++;
+}
+
+static inline void frameAction_accept(FrameFsm *f, uint8_t input) {
+    (void)input;
+    f->frames++;
+    if (f->onFrame) {
+        f->onFrame(f, f->context);
+    }
+}
+
+static inline void frameAction_reject(FrameFsm *f, uint8_t input) {
+    (void)input;
+    f->rejected++;
+}
+
+// ---- Um manipulador por estado, gerado das transições ----
+//
+// Cada frameState_<nome> expande todas as transições; as de outra origem
+// caem pela comparação constante com 'self' e o compilador as remove.
+
+#define FRAME_FSM_TRANSITION(from, guard, action, to)                 \
+    if (FRAME_FSM_##from == self && frameGuard_##guard(f, input)) {   \
+        frameAction_##action(f, input);                               \
+        return FRAME_FSM_##to;                                        \
+    }
+
+#define FRAME_FSM_HANDLER(name)                                                   \
+    static inline uint8_t frameState_##name(FrameFsm *f, uint8_t input) {        \
+        const FrameFsmState self = FRAME_FSM_##name;                              \
+        FRAME_FSM_TRANSITIONS(FRAME_FSM_TRANSITION)                               \
+        return self;                                                              \
+    }
+
+FRAME_FSM_STATES(FRAME_FSM_HANDLER)
+
+#undef FRAME_FSM_HANDLER
+#undef FRAME_FSM_TRANSITION
+
+// ---- Motor 1: switch ----
+
+static inline size_t frameFsmRunSwitch(FrameFsm *f, const uint8_t *buf, size_t len,
+                                       FrameFsmCallback onFrame, void *context) {
+    size_t before = f->frames;
+    f->onFrame = onFrame;
+    f->context = context;
+    for (size_t i = 0; i < len; i++) {
+        switch (f->state) {
+#define FRAME_FSM_CASE(name)                             \
+            case FRAME_FSM_##name:                       \
+                f->state = frameState_##name(f, buf[i]); \
+                break;
+            FRAME_FSM_STATES(FRAME_FSM_CASE)
+#undef FRAME_FSM_CASE
+        }
+    }
+    return f->frames - before;
+}
+
+// ---- Motor 2: tabela de ponteiros de função ----
+
+typedef uint8_t (*FrameFsmHandler)(FrameFsm *f, uint8_t input);
+
+#define FRAME_FSM_POINTER(name) frameState_##name,
+static FrameFsmHandler const frameFsmHandlers[FRAME_FSM_STATE_COUNT] = {
+    FRAME_FSM_STATES(FRAME_FSM_POINTER)
+};
+#undef FRAME_FSM_POINTER
+
+static inline size_t frameFsmRunTable(FrameFsm *f, const uint8_t *buf, size_t len,
+                                      FrameFsmCallback onFrame, void *context) {
+    size_t before = f->frames;
+    f->onFrame = onFrame;
+    f->context = context;
+    for (size_t i = 0; i < len; i++) {
+        f->state = frameFsmHandlers[f->state](f, buf[i]);
+    }
+    return f->frames - before;
+}
+
+// ---- Motor 3: goto computado ----
+//
+// Cada estado é um rótulo; depois de tratar um byte o próximo estado é o
+// endereço do rótulo (goto *), sem voltar a um ponto único de despacho.
+// O estado só é gravado em f->state no fim do bloco. Sem GCC/Clang
+// (rótulos como valores) cai no motor de switch.
+
+#if defined(__GNUC__)
+static inline size_t frameFsmRunGoto(FrameFsm *f, const uint8_t *buf, size_t len,
+                                     FrameFsmCallback onFrame, void *context) {
+#define FRAME_FSM_LABEL(name) &&frameLabel_##name,
+    static void *const labels[FRAME_FSM_STATE_COUNT] = {
+        FRAME_FSM_STATES(FRAME_FSM_LABEL)
+    };
+#undef FRAME_FSM_LABEL
+    size_t before = f->frames;
+    const uint8_t *p = buf, *end = buf + len;
+    uint8_t next;
+    f->onFrame = onFrame;
+    f->context = context;
+    if (p == end) {
+        return 0;
+    }
+    goto *labels[f->state];
+
+#define FRAME_FSM_GOTO(name)                     \
+frameLabel_##name:                               \
+    next = frameState_##name(f, *p);             \
+    if (++p == end) {                            \
+        f->state = next;                         \
+        return f->frames - before;               \
+    }                                            \
+    goto *labels[next];
+
+    FRAME_FSM_STATES(FRAME_FSM_GOTO)
+#undef FRAME_FSM_GOTO
+}
+#else
+#define frameFsmRunGoto frameFsmRunSwitch
+#endif
+
+#endif // FRAME_FSM_H